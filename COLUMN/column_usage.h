@@ -0,0 +1,392 @@
+/* COLUMN/column_usage.h
+ *
+ * Requires: sample_structure.h, WIRE/wire_usage.h (in-tree format, no library)
+ * Exports:
+ *   int column_encode(const wifi_softap_info_t *info, void *out_buffer, size_t *out_size);
+ *   int column_decode(void *buffer, size_t size, wifi_softap_info_t *out_info);
+ *   int column_encode_array(const wifi_softap_info_t *infos, int count, void *out_buffer, size_t *out_size);
+ *   int column_decode_array(void *buf, size_t size, wifi_softap_info_t *out_infos, int *out_count);
+ *   int column_encode_records(const wifi_softap_info_t *infos, int count, void *out, size_t capacity, size_t *out_size);
+ *   int column_decode_records(const void *buf, size_t size, wifi_softap_info_t *out_infos, int capacity, int *out_count);
+ *   int column_decode_batch(const void *buf, size_t size, column_batch_t *batch);
+ *
+ * Notes:
+ * - Struct-of-arrays batch: every field of the batch is one contiguous
+ *   column, each with its own encoding. Meant for large scans, the
+ *   *_records / *_batch functions take any count that fits the buffers;
+ *   the encode/decode dispatch in main.c is limited to MAX_ARRAY, the
+ *   batch test and benchmark in main.c run 5000 records.
+ * - Layout, header then columns, N = record count:
+ *     header: 'W' 'C' version(u8) flags(u8) N(u32 LE)
+ *     state        2 bits per record, 4 per byte     (N + 3) / 4 bytes
+ *     security     2 bits per record, 4 per byte     (N + 3) / 4 bytes
+ *     channel      N bytes
+ *     ssid length  N bytes
+ *     ipv4         N * 4 bytes
+ *     ipv6         N * 16 bytes
+ *     bssid        N * 6 bytes
+ *     device_count N varints, zigzag of the delta to the previous record
+ *     frequency    N varints, zigzag of the delta to the previous record
+ *     ssid         blob, the ssids back to back (sum of the lengths)
+ *   The fixed-size columns come first, so their offsets only depend on N.
+ * - Deltas wrap in 32 / 16 bits, any int / uint16_t value round-trips.
+ * - state and security must be 0-3 to be encoded.
+ */
+
+#ifndef COLUMN_USAGE_H
+#define COLUMN_USAGE_H
+
+#include "../WIRE/wire_usage.h"
+#include "../sample_structure.h" /* defines wifi_softap_info_t, constants */
+
+#define COLUMN_MAGIC_0 'W'
+#define COLUMN_MAGIC_1 'C'
+#define COLUMN_VERSION 1
+#define COLUMN_HEADER_SIZE 8
+
+
+/*
+ * Struct-of-arrays view of a decoded batch.
+ * The caller points the decoded columns at storage for `capacity` records
+ * (ssid_offset: capacity + 1); the other columns are views into the buffer
+ * and live as long as it does.
+ */
+typedef struct {
+    int capacity;
+    int count;
+    /* decoded into caller storage */
+    int32_t* device_count;
+    uint8_t* state;
+    uint8_t* security;
+    uint16_t* frequency;
+    uint32_t* ssid_offset; /* ssid i is ssid_blob[ssid_offset[i] .. ssid_offset[i + 1]) */
+    /* views into the buffer */
+    const uint8_t* channel;
+    const uint8_t* ipv4;  /* count * IPV4_LEN */
+    const uint8_t* ipv6;  /* count * IPV6_LEN */
+    const uint8_t* bssid; /* count * WIFI_BT_MAC_ADDRESS_LEN */
+    const char* ssid_blob;
+} column_batch_t;
+
+/* offsets of the fixed-size columns for n records */
+typedef struct {
+    size_t state, security, channel, ssid_len, ipv4, ipv6, bssid, varints;
+} column_layout_t;
+
+static inline void column_layout(size_t n, column_layout_t* layout) {
+    size_t bits = (n + 3) / 4;
+    layout->state = COLUMN_HEADER_SIZE;
+    layout->security = layout->state + bits;
+    layout->channel = layout->security + bits;
+    layout->ssid_len = layout->channel + n;
+    layout->ipv4 = layout->ssid_len + n;
+    layout->ipv6 = layout->ipv4 + n * IPV4_LEN;
+    layout->bssid = layout->ipv6 + n * IPV6_LEN;
+    layout->varints = layout->bssid + n * WIFI_BT_MAC_ADDRESS_LEN;
+}
+
+/* ---------- column encodings ---------- */
+static inline void column_pack2(uint8_t* out, const uint8_t* values, size_t n) {
+    memset(out, 0, (n + 3) / 4);
+    for (size_t i = 0; i < n; i++) {
+        out[i / 4] |= (uint8_t)(values[i] << (2 * (i % 4)));
+    }
+}
+
+static inline void column_unpack2(uint8_t* out, const uint8_t* in, size_t n) {
+    for (size_t i = 0; i < n; i++) {
+        out[i] = (in[i / 4] >> (2 * (i % 4))) & 3;
+    }
+}
+
+/* worst case encoded size of n records, or 0 if the ssids are not terminated */
+static inline size_t column_max_size(const wifi_softap_info_t* infos, size_t n) {
+    column_layout_t layout;
+    size_t ssid_total = 0;
+    for (size_t i = 0; i < n; i++) {
+        size_t len = strnlen(infos[i].ssid, WIFI_SSID_MAX_LEN + 1);
+        if (len > WIFI_SSID_MAX_LEN) return 0;
+        ssid_total += len;
+    }
+    column_layout(n, &layout);
+    return layout.varints + n * (WIRE_VARINT32_MAX + WIRE_VARINT16_MAX) + ssid_total;
+}
+
+/*
+ * column_encode_records
+ *  - input: wifi_softap_info_t *infos, int count, capacity of *out
+ *  - output: *out, *out_size
+ *  - return: 0 on success, -1 on failure
+ * Fails if capacity is below the worst case size for the records, even when
+ * the actual encoding would have fit.
+ */
+int column_encode_records(const wifi_softap_info_t* infos, int count, void* out, size_t capacity, size_t* out_size) {
+    if (!infos || count <= 0 || !out || !out_size) return -1;
+
+    size_t n = (size_t)count;
+    size_t max_size = column_max_size(infos, n);
+    if (max_size == 0 || max_size > capacity) {
+        fprintf(stderr, "Column encode failed: %d records need up to %zu bytes, have %zu\n", count, max_size, capacity);
+        return -1;
+    }
+
+    uint8_t* base = (uint8_t*)out;
+    column_layout_t layout;
+    column_layout(n, &layout);
+
+    base[0] = COLUMN_MAGIC_0;
+    base[1] = COLUMN_MAGIC_1;
+    base[2] = COLUMN_VERSION;
+    base[3] = 0;
+    wire_put_le32(base + 4, (uint32_t)count);
+
+    /* 2-bit columns: staged one byte per record, then packed */
+    uint8_t* state = base + layout.channel; /* staging, overwritten by the channel column below */
+    for (size_t i = 0; i < n; i++) {
+        if ((unsigned)infos[i].state > 3 || (unsigned)infos[i].security > 3) {
+            fprintf(stderr, "Column encode failed: record %zu state/security out of range\n", i);
+            return -1;
+        }
+        state[i] = (uint8_t)infos[i].state;
+    }
+    column_pack2(base + layout.state, state, n);
+    for (size_t i = 0; i < n; i++) state[i] = (uint8_t)infos[i].security;
+    column_pack2(base + layout.security, state, n);
+
+    for (size_t i = 0; i < n; i++) base[layout.channel + i] = infos[i].channel;
+    for (size_t i = 0; i < n; i++) base[layout.ssid_len + i] = (uint8_t)strlen(infos[i].ssid);
+    for (size_t i = 0; i < n; i++) memcpy(base + layout.ipv4 + i * IPV4_LEN, infos[i].ip_address.ipv4, IPV4_LEN);
+    for (size_t i = 0; i < n; i++) memcpy(base + layout.ipv6 + i * IPV6_LEN, infos[i].ip_address.ipv6, IPV6_LEN);
+    for (size_t i = 0; i < n; i++) {
+        memcpy(base + layout.bssid + i * WIFI_BT_MAC_ADDRESS_LEN, infos[i].bssid, WIFI_BT_MAC_ADDRESS_LEN);
+    }
+
+    uint8_t* p = base + layout.varints;
+    uint32_t prev = 0;
+    for (size_t i = 0; i < n; i++) {
+        uint32_t value = (uint32_t)infos[i].device_count;
+        p = wire_put_varint(p, wire_zigzag32((int32_t)(value - prev)));
+        prev = value;
+    }
+    uint16_t prev_frequency = 0;
+    for (size_t i = 0; i < n; i++) {
+        int16_t delta = (int16_t)(uint16_t)(infos[i].frequency - prev_frequency);
+        p = wire_put_varint(p, wire_zigzag32(delta));
+        prev_frequency = infos[i].frequency;
+    }
+    for (size_t i = 0; i < n; i++) {
+        size_t len = base[layout.ssid_len + i];
+        memcpy(p, infos[i].ssid, len);
+        p += len;
+    }
+
+    *out_size = (size_t)(p - base);
+    return 0;
+}
+
+/*
+ * column_decode_batch
+ *  - input: *buf, size; batch->capacity and the decoded column storage
+ *  - output: column_batch_t *batch
+ *  - return: 0 on success, -1 on failure
+ */
+int column_decode_batch(const void* buf, size_t size, column_batch_t* batch) {
+    const uint8_t* base = (const uint8_t*)buf;
+    if (!base || !batch) return -1;
+
+    if (size < COLUMN_HEADER_SIZE || base[0] != COLUMN_MAGIC_0 || base[1] != COLUMN_MAGIC_1 ||
+        base[2] != COLUMN_VERSION) {
+        fprintf(stderr, "Column decode failed: not a version %d column batch\n", COLUMN_VERSION);
+        return -1;
+    }
+    uint32_t count = wire_get_le32(base + 4);
+
+    column_layout_t layout;
+    if (count > (uint32_t)batch->capacity || count > size) {
+        fprintf(stderr, "Column decode failed: %u records, room for %d\n", count, batch->capacity);
+        return -1;
+    }
+    size_t n = count;
+    column_layout(n, &layout);
+    /* every record has at least two varint bytes */
+    if (layout.varints + 2 * n > size) {
+        fprintf(stderr, "Column decode failed: %u records do not fit %zu bytes\n", count, size);
+        return -1;
+    }
+
+    column_unpack2(batch->state, base + layout.state, n);
+    column_unpack2(batch->security, base + layout.security, n);
+
+    uint32_t offset = 0;
+    for (size_t i = 0; i < n; i++) {
+        uint8_t len = base[layout.ssid_len + i];
+        if (len > WIFI_SSID_MAX_LEN) {
+            fprintf(stderr, "Column decode failed: ssid %zu is %u bytes\n", i, len);
+            return -1;
+        }
+        batch->ssid_offset[i] = offset;
+        offset += len;
+    }
+    batch->ssid_offset[n] = offset;
+
+    const uint8_t* end = base + size;
+    const uint8_t* p = base + layout.varints;
+    uint32_t value, prev = 0;
+    for (size_t i = 0; i < n; i++) {
+        if (!(p = wire_get_varint(p, end, WIRE_VARINT32_MAX, &value))) goto truncated;
+        prev += (uint32_t)wire_unzigzag32(value);
+        batch->device_count[i] = (int32_t)prev;
+    }
+    uint16_t frequency = 0;
+    for (size_t i = 0; i < n; i++) {
+        if (!(p = wire_get_varint(p, end, WIRE_VARINT16_MAX, &value)) || value > 0xFFFF) goto truncated;
+        frequency = (uint16_t)(frequency + wire_unzigzag32(value));
+        batch->frequency[i] = frequency;
+    }
+    if ((size_t)(end - p) != offset) {
+        fprintf(stderr, "Column decode failed: ssid blob is %zu bytes, expected %u\n", (size_t)(end - p), offset);
+        return -1;
+    }
+
+    batch->count = (int)count;
+    batch->channel = base + layout.channel;
+    batch->ipv4 = base + layout.ipv4;
+    batch->ipv6 = base + layout.ipv6;
+    batch->bssid = base + layout.bssid;
+    batch->ssid_blob = (const char*)p;
+    return 0;
+
+truncated:
+    fprintf(stderr, "Column decode failed: bad varint column\n");
+    return -1;
+}
+
+/*
+ * column_decode_records
+ *  - input: *buf, size, capacity of out_infos
+ *  - output: wifi_softap_info_t *out_infos, *out_count
+ *  - return: 0 on success, -1 on failure
+ * Decodes column by column straight into the array of structs; the packed
+ * columns are staged in out_infos itself, so no scratch is needed.
+ */
+int column_decode_records(const void* buf, size_t size, wifi_softap_info_t* out_infos, int capacity, int* out_count) {
+    const uint8_t* base = (const uint8_t*)buf;
+    if (!base || !out_infos || capacity <= 0 || !out_count) return -1;
+
+    if (size < COLUMN_HEADER_SIZE || base[0] != COLUMN_MAGIC_0 || base[1] != COLUMN_MAGIC_1 ||
+        base[2] != COLUMN_VERSION) {
+        fprintf(stderr, "Column decode failed: not a version %d column batch\n", COLUMN_VERSION);
+        return -1;
+    }
+    uint32_t count = wire_get_le32(base + 4);
+    if (count > (uint32_t)capacity || count > size) {
+        fprintf(stderr, "Column decode failed: %u records, room for %d\n", count, capacity);
+        return -1;
+    }
+
+    size_t n = count;
+    column_layout_t layout;
+    column_layout(n, &layout);
+    if (layout.varints + 2 * n > size) {
+        fprintf(stderr, "Column decode failed: %u records do not fit %zu bytes\n", count, size);
+        return -1;
+    }
+
+    const uint8_t* state = base + layout.state;
+    const uint8_t* security = base + layout.security;
+    for (size_t i = 0; i < n; i++) {
+        out_infos[i].state = (wifi_softap_state_t)((state[i / 4] >> (2 * (i % 4))) & 3);
+        out_infos[i].security = (security_type_t)((security[i / 4] >> (2 * (i % 4))) & 3);
+    }
+    for (size_t i = 0; i < n; i++) out_infos[i].channel = base[layout.channel + i];
+    for (size_t i = 0; i < n; i++) memcpy(out_infos[i].ip_address.ipv4, base + layout.ipv4 + i * IPV4_LEN, IPV4_LEN);
+    for (size_t i = 0; i < n; i++) memcpy(out_infos[i].ip_address.ipv6, base + layout.ipv6 + i * IPV6_LEN, IPV6_LEN);
+    for (size_t i = 0; i < n; i++) {
+        memcpy(out_infos[i].bssid, base + layout.bssid + i * WIFI_BT_MAC_ADDRESS_LEN, WIFI_BT_MAC_ADDRESS_LEN);
+    }
+
+    const uint8_t* end = base + size;
+    const uint8_t* p = base + layout.varints;
+    uint32_t value, prev = 0;
+    for (size_t i = 0; i < n; i++) {
+        if (!(p = wire_get_varint(p, end, WIRE_VARINT32_MAX, &value))) goto truncated;
+        prev += (uint32_t)wire_unzigzag32(value);
+        out_infos[i].device_count = (int32_t)prev;
+    }
+    uint16_t frequency = 0;
+    for (size_t i = 0; i < n; i++) {
+        if (!(p = wire_get_varint(p, end, WIRE_VARINT16_MAX, &value)) || value > 0xFFFF) goto truncated;
+        frequency = (uint16_t)(frequency + wire_unzigzag32(value));
+        out_infos[i].frequency = frequency;
+    }
+
+    for (size_t i = 0; i < n; i++) {
+        uint8_t len = base[layout.ssid_len + i];
+        if (len > WIFI_SSID_MAX_LEN || len > (size_t)(end - p)) {
+            fprintf(stderr, "Column decode failed: bad ssid %zu\n", i);
+            return -1;
+        }
+        memcpy(out_infos[i].ssid, p, len);
+        out_infos[i].ssid[len] = '\0';
+        p += len;
+    }
+    if (p != end) {
+        fprintf(stderr, "Column decode failed: %zu trailing bytes\n", (size_t)(end - p));
+        return -1;
+    }
+
+    *out_count = (int)count;
+    return 0;
+
+truncated:
+    fprintf(stderr, "Column decode failed: bad varint column\n");
+    return -1;
+}
+
+/*
+ * column_encode
+ *  - input: wifi_softap_info_t *info
+ *  - output: *out_buffer, *out_size
+ *  - return: 0 on success, -1 on failure
+ */
+int column_encode(const wifi_softap_info_t* info, void* out_buffer, size_t* out_size) {
+    return column_encode_records(info, 1, out_buffer, MAX_BUFFER, out_size);
+}
+
+/*
+ * column_decode
+ *  - input: *buffer, size
+ *  - output: wifi_softap_info_t *out_info
+ *  - return: 0 on success, -1 on failure
+ */
+int column_decode(void* buffer, size_t size, wifi_softap_info_t* out_info) {
+    int count = 0;
+    if (column_decode_records(buffer, size, out_info, 1, &count) != 0) return -1;
+    if (count != 1) {
+        fprintf(stderr, "Column decode failed: expected 1 record, got %d\n", count);
+        return -1;
+    }
+    return 0;
+}
+
+/*
+ * column_encode_array
+ *  - input: wifi_softap_info_t *infos, int count
+ *  - output: *out_buffer, *out_size
+ *  - return: 0 on success, -1 on failure
+ */
+int column_encode_array(const wifi_softap_info_t* infos, int count, void* out_buffer, size_t* out_size) {
+    return column_encode_records(infos, count, out_buffer, MAX_BUFFER, out_size);
+}
+
+/*
+ * column_decode_array
+ *  - input: *buf, size
+ *  - output: wifi_softap_info_t *out_infos (up to MAX_ARRAY), *out_count
+ *  - return: 0 on success, -1 on failure
+ */
+int column_decode_array(void* buf, size_t size, wifi_softap_info_t* out_infos, int* out_count) {
+    return column_decode_records(buf, size, out_infos, MAX_ARRAY, out_count);
+}
+
+#endif /* COLUMN_USAGE_H */
@@ -0,0 +1,224 @@
+/* COMPACT/compact_usage.h
+ *
+ * Requires: sample_structure.h, WIRE/wire_usage.h (in-tree format, no library)
+ * Exports:
+ *   int compact_encode(const wifi_softap_info_t *info, void *out_buffer, size_t *out_size);
+ *   int compact_decode(void *buffer, size_t size, wifi_softap_info_t *out_info);
+ *   int compact_encode_array(const wifi_softap_info_t *infos, int count, void *out_buffer, size_t *out_size);
+ *   int compact_decode_array(void *buf, size_t size, wifi_softap_info_t *out_infos, int *out_count);
+ *   uint16_t compact_channel_frequency(uint8_t channel);
+ *
+ * Notes:
+ * - Schema-aware record: what the value of one field says about another is
+ *   not sent again.
+ *     flags   (u8)   bits 0-1 state, bits 2-3 security,
+ *                    COMPACT_HAS_IPV6, COMPACT_HAS_FREQUENCY, COMPACT_HAS_DEVICE_COUNT
+ *     channel (u8)
+ *     frequency      u16 LE, only if it is not compact_channel_frequency(channel)
+ *     device_count   zigzag varint, only if not 0
+ *     ipv4    [4]
+ *     ipv6    [16]   only if not all zero
+ *     bssid   [6]
+ *     ssid_len (u8), ssid bytes
+ *   14 bytes plus the ssid for a 2.4 / 5 GHz AP with an IPv4 address only.
+ * - A single record is the record; an array is a varint count followed by
+ *   the records back to back.
+ * - state and security must be 0-3 to be encoded, the last flag bit is
+ *   reserved and must be 0.
+ */
+
+#ifndef COMPACT_USAGE_H
+#define COMPACT_USAGE_H
+
+#include "../WIRE/wire_usage.h"
+#include "../sample_structure.h" /* defines wifi_softap_info_t, constants */
+
+#define COMPACT_STATE_MASK 0x03
+#define COMPACT_SECURITY_SHIFT 2
+#define COMPACT_HAS_IPV6 0x10
+#define COMPACT_HAS_FREQUENCY 0x20
+#define COMPACT_HAS_DEVICE_COUNT 0x40
+#define COMPACT_RESERVED 0x80
+
+/* flags, channel, frequency, device_count, ipv4, ipv6, bssid, ssid_len, ssid */
+#define COMPACT_RECORD_MAX (1 + 1 + 2 + 5 + IPV4_LEN + IPV6_LEN + WIFI_BT_MAC_ADDRESS_LEN + 1 + WIFI_SSID_MAX_LEN)
+
+/*
+ * compact_channel_frequency
+ *  - input: channel number
+ *  - return: the centre frequency in MHz the channel implies, 0 if none
+ * 2.4 GHz: 1-13 are 2407 + 5 * ch, 14 is 2484; 5 GHz: 32-177 are 5000 + 5 * ch.
+ */
+uint16_t compact_channel_frequency(uint8_t channel) {
+    if (channel >= 1 && channel <= 13) return (uint16_t)(2407 + 5 * channel);
+    if (channel == 14) return 2484;
+    if (channel >= 32 && channel <= 177) return (uint16_t)(5000 + 5 * channel);
+    return 0;
+}
+
+static inline int compact_is_zero(const uint8_t* bytes, size_t size) {
+    for (size_t i = 0; i < size; i++) {
+        if (bytes[i]) return 0;
+    }
+    return 1;
+}
+
+/* NULL if the record can not be encoded; p needs COMPACT_RECORD_MAX bytes */
+static inline uint8_t* compact_put_record(uint8_t* p, const wifi_softap_info_t* info) {
+    size_t ssid_len = strnlen(info->ssid, WIFI_SSID_MAX_LEN + 1);
+    if ((unsigned)info->state > 3 || (unsigned)info->security > 3 || ssid_len > WIFI_SSID_MAX_LEN) {
+        fprintf(stderr, "Compact encode failed: state, security or ssid out of range\n");
+        return NULL;
+    }
+
+    uint8_t flags = (uint8_t)(info->state | (info->security << COMPACT_SECURITY_SHIFT));
+    int has_ipv6 = !compact_is_zero(info->ip_address.ipv6, IPV6_LEN);
+    int has_frequency = info->frequency != compact_channel_frequency(info->channel);
+    if (has_ipv6) flags |= COMPACT_HAS_IPV6;
+    if (has_frequency) flags |= COMPACT_HAS_FREQUENCY;
+    if (info->device_count != 0) flags |= COMPACT_HAS_DEVICE_COUNT;
+
+    *p++ = flags;
+    *p++ = info->channel;
+    if (has_frequency) p = wire_put_le16(p, info->frequency);
+    if (info->device_count != 0) p = wire_put_varint(p, wire_zigzag32(info->device_count));
+    memcpy(p, info->ip_address.ipv4, IPV4_LEN);
+    p += IPV4_LEN;
+    if (has_ipv6) {
+        memcpy(p, info->ip_address.ipv6, IPV6_LEN);
+        p += IPV6_LEN;
+    }
+    memcpy(p, info->bssid, WIFI_BT_MAC_ADDRESS_LEN);
+    p += WIFI_BT_MAC_ADDRESS_LEN;
+    *p++ = (uint8_t)ssid_len;
+    memcpy(p, info->ssid, ssid_len);
+    return p + ssid_len;
+}
+
+/* NULL if the record is malformed or runs past end */
+static inline const uint8_t* compact_get_record(const uint8_t* p, const uint8_t* end, wifi_softap_info_t* info) {
+    if (end - p < 2) return NULL;
+    uint8_t flags = *p++;
+    if (flags & COMPACT_RESERVED) return NULL;
+
+    info->state = (wifi_softap_state_t)(flags & COMPACT_STATE_MASK);
+    info->security = (security_type_t)((flags >> COMPACT_SECURITY_SHIFT) & COMPACT_STATE_MASK);
+    info->channel = *p++;
+    if (flags & COMPACT_HAS_FREQUENCY) {
+        if (end - p < 2) return NULL;
+        info->frequency = wire_get_le16(p);
+        p += 2;
+    } else {
+        info->frequency = compact_channel_frequency(info->channel);
+    }
+    info->device_count = 0;
+    if (flags & COMPACT_HAS_DEVICE_COUNT) {
+        uint32_t value;
+        if (!(p = wire_get_varint(p, end, WIRE_VARINT32_MAX, &value))) return NULL;
+        info->device_count = wire_unzigzag32(value);
+    }
+
+    size_t fixed = IPV4_LEN + ((flags & COMPACT_HAS_IPV6) ? IPV6_LEN : 0) + WIFI_BT_MAC_ADDRESS_LEN + 1;
+    if ((size_t)(end - p) < fixed) return NULL;
+    memcpy(info->ip_address.ipv4, p, IPV4_LEN);
+    p += IPV4_LEN;
+    if (flags & COMPACT_HAS_IPV6) {
+        memcpy(info->ip_address.ipv6, p, IPV6_LEN);
+        p += IPV6_LEN;
+    } else {
+        memset(info->ip_address.ipv6, 0, IPV6_LEN);
+    }
+    memcpy(info->bssid, p, WIFI_BT_MAC_ADDRESS_LEN);
+    p += WIFI_BT_MAC_ADDRESS_LEN;
+
+    size_t ssid_len = *p++;
+    if (ssid_len > WIFI_SSID_MAX_LEN || ssid_len > (size_t)(end - p)) return NULL;
+    memcpy(info->ssid, p, ssid_len);
+    info->ssid[ssid_len] = '\0';
+    return p + ssid_len;
+}
+
+/*
+ * compact_encode
+ *  - input: wifi_softap_info_t *info
+ *  - output: *out_buffer, *out_size
+ *  - return: 0 on success, -1 on failure
+ */
+int compact_encode(const wifi_softap_info_t* info, void* out_buffer, size_t* out_size) {
+    if (!info || !out_buffer || !out_size) return -1;
+
+    uint8_t* end = compact_put_record((uint8_t*)out_buffer, info);
+    if (!end) return -1;
+    *out_size = (size_t)(end - (uint8_t*)out_buffer);
+    return 0;
+}
+
+/*
+ * compact_decode
+ *  - input: *buffer, size
+ *  - output: wifi_softap_info_t *out_info
+ *  - return: 0 on success, -1 on failure
+ */
+int compact_decode(void* buffer, size_t size, wifi_softap_info_t* out_info) {
+    if (!buffer || !out_info) return -1;
+
+    const uint8_t* end = (const uint8_t*)buffer + size;
+    if (compact_get_record((const uint8_t*)buffer, end, out_info) != end) {
+        fprintf(stderr, "Compact decode failed: malformed record\n");
+        return -1;
+    }
+    return 0;
+}
+
+/*
+ * compact_encode_array
+ *  - input: wifi_softap_info_t *infos, int count
+ *  - output: *out_buffer, *out_size
+ *  - return: 0 on success, -1 on failure
+ */
+int compact_encode_array(const wifi_softap_info_t* infos, int count, void* out_buffer, size_t* out_size) {
+    if (!infos || count <= 0 || !out_buffer || !out_size) return -1;
+    if (5 + (size_t)count * COMPACT_RECORD_MAX > MAX_BUFFER) {
+        fprintf(stderr, "Compact encode failed: %d records may not fit\n", count);
+        return -1;
+    }
+
+    uint8_t* p = wire_put_varint((uint8_t*)out_buffer, (uint32_t)count);
+    for (int i = 0; i < count; i++) {
+        if (!(p = compact_put_record(p, &infos[i]))) return -1;
+    }
+    *out_size = (size_t)(p - (uint8_t*)out_buffer);
+    return 0;
+}
+
+/*
+ * compact_decode_array
+ *  - input: *buf, size
+ *  - output: wifi_softap_info_t *out_infos (up to MAX_ARRAY), *out_count
+ *  - return: 0 on success, -1 on failure
+ */
+int compact_decode_array(void* buf, size_t size, wifi_softap_info_t* out_infos, int* out_count) {
+    if (!buf || !out_infos || !out_count) return -1;
+
+    const uint8_t* end = (const uint8_t*)buf + size;
+    uint32_t count;
+    const uint8_t* p = wire_get_varint((const uint8_t*)buf, end, WIRE_VARINT32_MAX, &count);
+    if (!p || count > MAX_ARRAY) {
+        fprintf(stderr, "Compact decode failed: bad record count\n");
+        return -1;
+    }
+    for (uint32_t i = 0; i < count; i++) {
+        if (!(p = compact_get_record(p, end, &out_infos[i]))) {
+            fprintf(stderr, "Compact decode failed: malformed record %u\n", i);
+            return -1;
+        }
+    }
+    if (p != end) {
+        fprintf(stderr, "Compact decode failed: %zu trailing bytes\n", (size_t)(end - p));
+        return -1;
+    }
+    *out_count = (int)count;
+    return 0;
+}
+
+#endif /* COMPACT_USAGE_H */
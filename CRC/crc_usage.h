@@ -0,0 +1,132 @@
+/* CRC/crc_usage.h
+ *
+ * Requires: nothing (in-tree, no library)
+ * Exports:
+ *   uint32_t crc32c_sw(uint32_t crc, const void *data, size_t size);
+ *   uint32_t crc32c_hw(uint32_t crc, const void *data, size_t size);
+ *   int crc32c_hw_available(void);
+ *
+ * Notes:
+ * - CRC-32C (Castagnoli, reflected polynomial 0x82F63B78), the checksum of
+ *   iSCSI, ext4 and SCTP; crc32c_hw(0, "123456789", 9) is 0xE3069283.
+ * - crc is the result of the previous call (0 to start), so a payload in
+ *   pieces gives the same value as the payload in one piece.
+ * - crc32c_hw is the one to call: the SSE4.2 crc32 instruction, 8 bytes per
+ *   instruction, if the CPU has it. Only that code is compiled for SSE4.2,
+ *   the rest of the program is not.
+ * - crc32c_sw is slicing-by-8: eight 256-entry tables, built on first use,
+ *   look up 8 bytes per step. crc32c_hw falls back to it on other CPUs, and
+ *   always when built with -D CRC32C_NO_HW.
+ */
+
+#ifndef CRC_USAGE_H
+#define CRC_USAGE_H
+
+#include <stddef.h>
+#include <stdint.h>
+#include <string.h>
+
+#if (defined(__x86_64__) || defined(__i386__)) && !defined(CRC32C_NO_HW)
+#define CRC32C_HAVE_HW 1
+#include <nmmintrin.h>
+#else
+#define CRC32C_HAVE_HW 0
+#endif
+
+#define CRC32C_POLY 0x82F63B78u
+
+/* little-endian 8 bytes, whatever the host */
+static inline uint64_t crc32c_load_u64(const uint8_t* p) {
+    uint64_t value;
+    memcpy(&value, p, sizeof(value));
+#if defined(__BYTE_ORDER__) && __BYTE_ORDER__ == __ORDER_BIG_ENDIAN__
+    value = __builtin_bswap64(value);
+#endif
+    return value;
+}
+
+/* table[k][b]: the crc of byte b followed by k zero bytes */
+static const uint32_t (*crc32c_table(void))[256] {
+    static uint32_t table[8][256];
+    static int ready = 0;
+
+    if (!ready) {
+        for (uint32_t b = 0; b < 256; b++) {
+            uint32_t crc = b;
+            for (int bit = 0; bit < 8; bit++) crc = (crc >> 1) ^ (CRC32C_POLY & (0u - (crc & 1)));
+            table[0][b] = crc;
+        }
+        for (uint32_t b = 0; b < 256; b++) {
+            for (int k = 1; k < 8; k++) table[k][b] = (table[k - 1][b] >> 8) ^ table[0][table[k - 1][b] & 0xFF];
+        }
+        ready = 1;
+    }
+    return (const uint32_t(*)[256])table;
+}
+
+/*
+ * crc32c_sw
+ *  - input: crc (0, or the result for the bytes before), *data, size
+ *  - return: the crc of the bytes so far
+ */
+uint32_t crc32c_sw(uint32_t crc, const void* data, size_t size) {
+    const uint32_t(*t)[256] = crc32c_table();
+    const uint8_t* p = (const uint8_t*)data;
+
+    crc = ~crc;
+    for (; size >= 8; size -= 8, p += 8) {
+        uint64_t word = crc32c_load_u64(p) ^ crc;
+        crc = t[7][word & 0xFF] ^ t[6][(word >> 8) & 0xFF] ^ t[5][(word >> 16) & 0xFF] ^ t[4][(word >> 24) & 0xFF] ^
+              t[3][(word >> 32) & 0xFF] ^ t[2][(word >> 40) & 0xFF] ^ t[1][(word >> 48) & 0xFF] ^ t[0][word >> 56];
+    }
+    while (size--) crc = (crc >> 8) ^ t[0][(crc ^ *p++) & 0xFF];
+    return ~crc;
+}
+
+#if CRC32C_HAVE_HW
+__attribute__((target("sse4.2"))) static uint32_t crc32c_sse42(uint32_t crc, const uint8_t* p, size_t size) {
+#if defined(__x86_64__)
+    uint64_t crc64 = ~crc;
+    for (; size >= 8; size -= 8, p += 8) crc64 = _mm_crc32_u64(crc64, crc32c_load_u64(p));
+    crc = (uint32_t)crc64;
+#else
+    crc = ~crc;
+#endif
+    for (; size >= 4; size -= 4, p += 4) {
+        uint32_t word;
+        memcpy(&word, p, sizeof(word));
+        crc = _mm_crc32_u32(crc, word);
+    }
+    while (size--) crc = _mm_crc32_u8(crc, *p++);
+    return ~crc;
+}
+#endif
+
+/*
+ * crc32c_hw_available
+ *  - return: 1 if crc32c_hw runs on the crc32 instruction, 0 if it is crc32c_sw
+ */
+int crc32c_hw_available(void) {
+#if CRC32C_HAVE_HW
+    static int available = -1;
+    if (available < 0) available = __builtin_cpu_supports("sse4.2") ? 1 : 0;
+    return available;
+#else
+    return 0;
+#endif
+}
+
+/*
+ * crc32c_hw
+ *  - input: crc (0, or the result for the bytes before), *data, size
+ *  - return: the crc of the bytes so far; crc32c_sw's work if the CPU or the
+ *    build has no crc32 instruction
+ */
+uint32_t crc32c_hw(uint32_t crc, const void* data, size_t size) {
+#if CRC32C_HAVE_HW
+    if (crc32c_hw_available()) return crc32c_sse42(crc, (const uint8_t*)data, size);
+#endif
+    return crc32c_sw(crc, data, size);
+}
+
+#endif /* CRC_USAGE_H */
@@ -0,0 +1,430 @@
+/* DELTA/delta_usage.h
+ *
+ * Requires: sample_structure.h, WIRE/wire_usage.h (in-tree format, no library)
+ * Exports:
+ *   void delta_init(delta_state_t *state);
+ *   void delta_request_keyframe(delta_state_t *sender);
+ *   int delta_encode_snapshot(delta_state_t *sender, const wifi_softap_info_t *infos, int count,
+ *                             void *out, size_t capacity, size_t *out_size);
+ *   int delta_decode_snapshot(delta_state_t *receiver, const void *buf, size_t size,
+ *                             wifi_softap_info_t *out_infos, int capacity, int *out_count);
+ *   int delta_encode(const wifi_softap_info_t *info, void *out_buffer, size_t *out_size);
+ *   int delta_decode(void *buffer, size_t size, wifi_softap_info_t *out_info);
+ *   int delta_encode_array(const wifi_softap_info_t *infos, int count, void *out_buffer, size_t *out_size);
+ *   int delta_decode_array(void *buf, size_t size, wifi_softap_info_t *out_infos, int *out_count);
+ *
+ * Notes:
+ * - Stateful: sender and receiver each keep a delta_state_t with the last
+ *   record seen per BSSID, a message carries every AP of a snapshot but only
+ *   the fields that changed since that AP's last record.
+ *     header: 'W' 'D' version(u8) flags(u8) sequence(u32 LE), varint count
+ *     record: key (u8), table slot of the AP | DELTA_KEY_NEW | DELTA_KEY_CHANGED
+ *       bssid [6]                 if DELTA_KEY_NEW, the AP takes that slot
+ *       field bitmap (u8, DELTA_FIELD_*) and the changed fields, if DELTA_KEY_CHANGED:
+ *         device_count  zigzag varint of the difference
+ *         state, security, channel  u8
+ *         ipv4 [4], ipv6 [16], frequency u16 LE, ssid length + bytes
+ *   Both tables see the same inserts in the same order, so a known AP is
+ *   named by its slot; an unchanged one costs the key byte only.
+ * - A keyframe (DELTA_KEYFRAME) resets both tables, its records are diffed
+ *   against an all-zero record. The sender sends one for the first message,
+ *   every DELTA_KEYFRAME_INTERVAL messages, when its table is full and after
+ *   delta_request_keyframe().
+ * - The receiver applies a delta only if its sequence follows the last one
+ *   applied; on a gap or a bad message it drops out of sync and fails every
+ *   delta until the next keyframe.
+ * - state and security must be 0-3 to be encoded, a message with larger
+ *   ones is refused by the receiver.
+ * - encode()/decode() in main.c are one-shot, so the dispatch functions
+ *   send and accept keyframes only.
+ */
+
+#ifndef DELTA_USAGE_H
+#define DELTA_USAGE_H
+
+#include "../WIRE/wire_usage.h"
+#include "../sample_structure.h" /* defines wifi_softap_info_t, constants */
+
+#define DELTA_MAGIC_0 'W'
+#define DELTA_MAGIC_1 'D'
+#define DELTA_VERSION 1
+#define DELTA_HEADER_SIZE 8
+
+#define DELTA_KEYFRAME 0x01
+
+#define DELTA_FIELD_DEVICE_COUNT 0x01
+#define DELTA_FIELD_STATE 0x02
+#define DELTA_FIELD_IPV4 0x04
+#define DELTA_FIELD_IPV6 0x08
+#define DELTA_FIELD_SSID 0x10
+#define DELTA_FIELD_SECURITY 0x20
+#define DELTA_FIELD_CHANNEL 0x40
+#define DELTA_FIELD_FREQUENCY 0x80
+
+#define DELTA_KEY_SLOT_MASK 0x3F
+#define DELTA_KEY_NEW 0x40
+#define DELTA_KEY_CHANGED 0x80
+
+#define DELTA_KEYFRAME_INTERVAL 32
+#define DELTA_TABLE_SIZE 64 /* BSSIDs tracked, power of two */
+
+_Static_assert(DELTA_TABLE_SIZE <= DELTA_KEY_SLOT_MASK + 1, "slot must fit the record key");
+
+/* key, bssid, bitmap, then every field at its largest */
+#define DELTA_RECORD_MAX \
+    (1 + WIFI_BT_MAC_ADDRESS_LEN + 1 + 5 + 1 + IPV4_LEN + IPV6_LEN + 1 + WIFI_SSID_MAX_LEN + 1 + 1 + 2)
+
+typedef struct {
+    uint8_t used;
+    wifi_softap_info_t info; /* last record, bssid is the key */
+} delta_slot_t;
+
+typedef struct {
+    uint32_t sequence;   /* last sequence sent / applied */
+    int synced;          /* receiver: a keyframe was applied and no gap since */
+    int since_keyframe;  /* sender: messages since the last keyframe */
+    int force_keyframe;  /* sender: next message is a keyframe */
+    int used;
+    delta_slot_t slots[DELTA_TABLE_SIZE];
+} delta_state_t;
+
+/*
+ * delta_init
+ *  - output: delta_state_t *state, empty; the first message it sends is a keyframe
+ */
+void delta_init(delta_state_t* state) {
+    memset(state, 0, sizeof(*state));
+    state->force_keyframe = 1;
+}
+
+/*
+ * delta_request_keyframe
+ *  - output: the next delta_encode_snapshot() on sender sends a keyframe,
+ *    to call when the receiver reports it is out of sync
+ */
+void delta_request_keyframe(delta_state_t* sender) {
+    sender->force_keyframe = 1;
+}
+
+/* slots are cleared when they are taken again, dropping the flag is enough */
+static inline void delta_reset_table(delta_state_t* state) {
+    for (int i = 0; i < DELTA_TABLE_SIZE; i++) state->slots[i].used = 0;
+    state->used = 0;
+}
+
+/* slot of bssid, a new one (*created) if it is not in the table, NULL if the table is full */
+static inline delta_slot_t* delta_lookup(delta_state_t* state, const uint8_t* bssid, int* created) {
+    uint32_t hash = 2166136261u;
+    for (int i = 0; i < WIFI_BT_MAC_ADDRESS_LEN; i++) hash = (hash ^ bssid[i]) * 16777619u;
+
+    for (int probe = 0; probe < DELTA_TABLE_SIZE; probe++) {
+        delta_slot_t* slot = &state->slots[(hash + probe) & (DELTA_TABLE_SIZE - 1)];
+        if (!slot->used) {
+            slot->used = 1;
+            memset(&slot->info, 0, sizeof(slot->info));
+            memcpy(slot->info.bssid, bssid, WIFI_BT_MAC_ADDRESS_LEN);
+            state->used++;
+            *created = 1;
+            return slot;
+        }
+        if (memcmp(slot->info.bssid, bssid, WIFI_BT_MAC_ADDRESS_LEN) == 0) {
+            *created = 0;
+            return slot;
+        }
+    }
+    return NULL;
+}
+
+/* APs of infos not yet in the table */
+static inline int delta_new_bssids(delta_state_t* state, const wifi_softap_info_t* infos, int count) {
+    int added = 0;
+    for (int i = 0; i < count; i++) {
+        uint32_t hash = 2166136261u;
+        for (int b = 0; b < WIFI_BT_MAC_ADDRESS_LEN; b++) hash = (hash ^ infos[i].bssid[b]) * 16777619u;
+        int found = 0;
+        for (int probe = 0; probe < DELTA_TABLE_SIZE; probe++) {
+            const delta_slot_t* slot = &state->slots[(hash + probe) & (DELTA_TABLE_SIZE - 1)];
+            if (!slot->used) break;
+            if (memcmp(slot->info.bssid, infos[i].bssid, WIFI_BT_MAC_ADDRESS_LEN) == 0) {
+                found = 1;
+                break;
+            }
+        }
+        added += !found;
+    }
+    return added;
+}
+
+/* writes info as changes to *last and makes *last equal to info; key is slot | DELTA_KEY_NEW */
+static inline uint8_t* delta_put_record(uint8_t* p, uint8_t key, wifi_softap_info_t* last,
+                                        const wifi_softap_info_t* info) {
+    size_t ssid_len = strnlen(info->ssid, WIFI_SSID_MAX_LEN);
+    uint8_t bitmap = 0;
+    if (info->device_count != last->device_count) bitmap |= DELTA_FIELD_DEVICE_COUNT;
+    if (info->state != last->state) bitmap |= DELTA_FIELD_STATE;
+    if (memcmp(info->ip_address.ipv4, last->ip_address.ipv4, IPV4_LEN) != 0) bitmap |= DELTA_FIELD_IPV4;
+    if (memcmp(info->ip_address.ipv6, last->ip_address.ipv6, IPV6_LEN) != 0) bitmap |= DELTA_FIELD_IPV6;
+    if (strncmp(info->ssid, last->ssid, WIFI_SSID_MAX_LEN) != 0) bitmap |= DELTA_FIELD_SSID;
+    if (info->security != last->security) bitmap |= DELTA_FIELD_SECURITY;
+    if (info->channel != last->channel) bitmap |= DELTA_FIELD_CHANNEL;
+    if (info->frequency != last->frequency) bitmap |= DELTA_FIELD_FREQUENCY;
+
+    *p++ = bitmap ? (uint8_t)(key | DELTA_KEY_CHANGED) : key;
+    if (key & DELTA_KEY_NEW) {
+        memcpy(p, info->bssid, WIFI_BT_MAC_ADDRESS_LEN);
+        p += WIFI_BT_MAC_ADDRESS_LEN;
+    }
+    if (!bitmap) return p;
+    *p++ = bitmap;
+    if (bitmap & DELTA_FIELD_DEVICE_COUNT) {
+        int32_t diff = (int32_t)((uint32_t)info->device_count - (uint32_t)last->device_count);
+        p = wire_put_varint(p, wire_zigzag32(diff));
+    }
+    if (bitmap & DELTA_FIELD_STATE) *p++ = (uint8_t)info->state;
+    if (bitmap & DELTA_FIELD_IPV4) {
+        memcpy(p, info->ip_address.ipv4, IPV4_LEN);
+        p += IPV4_LEN;
+    }
+    if (bitmap & DELTA_FIELD_IPV6) {
+        memcpy(p, info->ip_address.ipv6, IPV6_LEN);
+        p += IPV6_LEN;
+    }
+    if (bitmap & DELTA_FIELD_SSID) {
+        *p++ = (uint8_t)ssid_len;
+        memcpy(p, info->ssid, ssid_len);
+        p += ssid_len;
+    }
+    if (bitmap & DELTA_FIELD_SECURITY) *p++ = (uint8_t)info->security;
+    if (bitmap & DELTA_FIELD_CHANNEL) *p++ = info->channel;
+    if (bitmap & DELTA_FIELD_FREQUENCY) p = wire_put_le16(p, info->frequency);
+
+    *last = *info;
+    memset(last->ssid + ssid_len, 0, sizeof(last->ssid) - ssid_len);
+    return p;
+}
+
+/* applies the bitmap and changes at p to *last; NULL if they run past end or are invalid */
+static inline const uint8_t* delta_get_record(const uint8_t* p, const uint8_t* end, wifi_softap_info_t* last) {
+    if (end - p < 1) return NULL;
+    uint8_t bitmap = *p++;
+
+    if (bitmap & DELTA_FIELD_DEVICE_COUNT) {
+        uint32_t value;
+        if (!(p = wire_get_varint(p, end, WIRE_VARINT32_MAX, &value))) return NULL;
+        int32_t diff = wire_unzigzag32(value);
+        last->device_count = (int32_t)((uint32_t)last->device_count + (uint32_t)diff);
+    }
+    if (bitmap & DELTA_FIELD_STATE) {
+        if (end - p < 1 || *p > 3) return NULL;
+        last->state = (wifi_softap_state_t)*p++;
+    }
+    if (bitmap & DELTA_FIELD_IPV4) {
+        if (end - p < IPV4_LEN) return NULL;
+        memcpy(last->ip_address.ipv4, p, IPV4_LEN);
+        p += IPV4_LEN;
+    }
+    if (bitmap & DELTA_FIELD_IPV6) {
+        if (end - p < IPV6_LEN) return NULL;
+        memcpy(last->ip_address.ipv6, p, IPV6_LEN);
+        p += IPV6_LEN;
+    }
+    if (bitmap & DELTA_FIELD_SSID) {
+        if (end - p < 1) return NULL;
+        size_t len = *p++;
+        if (len > WIFI_SSID_MAX_LEN || len > (size_t)(end - p)) return NULL;
+        memcpy(last->ssid, p, len);
+        memset(last->ssid + len, 0, sizeof(last->ssid) - len);
+        p += len;
+    }
+    if (bitmap & DELTA_FIELD_SECURITY) {
+        if (end - p < 1 || *p > 3) return NULL;
+        last->security = (security_type_t)*p++;
+    }
+    if (bitmap & DELTA_FIELD_CHANNEL) {
+        if (end - p < 1) return NULL;
+        last->channel = *p++;
+    }
+    if (bitmap & DELTA_FIELD_FREQUENCY) {
+        if (end - p < 2) return NULL;
+        last->frequency = wire_get_le16(p);
+        p += 2;
+    }
+    return p;
+}
+
+/*
+ * delta_encode_snapshot
+ *  - input: delta_state_t *sender, wifi_softap_info_t *infos, int count (up to DELTA_TABLE_SIZE),
+ *           capacity of *out
+ *  - output: *out, *out_size; sender holds infos as the last snapshot
+ *  - return: 0 on success, -1 on failure
+ */
+int delta_encode_snapshot(delta_state_t* sender, const wifi_softap_info_t* infos, int count, void* out,
+                          size_t capacity, size_t* out_size) {
+    if (!sender || !infos || count <= 0 || !out || !out_size) return -1;
+    if (count > DELTA_TABLE_SIZE || DELTA_HEADER_SIZE + 5 + (size_t)count * DELTA_RECORD_MAX > capacity) {
+        fprintf(stderr, "Delta encode failed: %d records do not fit\n", count);
+        return -1;
+    }
+    /* before the sender state changes: a refused snapshot sends nothing */
+    for (int i = 0; i < count; i++) {
+        if ((unsigned)infos[i].state > 3 || (unsigned)infos[i].security > 3) {
+            fprintf(stderr, "Delta encode failed: record %d state/security out of range\n", i);
+            return -1;
+        }
+    }
+
+    int keyframe = sender->force_keyframe || sender->since_keyframe + 1 >= DELTA_KEYFRAME_INTERVAL ||
+                   sender->used + delta_new_bssids(sender, infos, count) > DELTA_TABLE_SIZE;
+    if (keyframe) {
+        delta_reset_table(sender);
+        sender->force_keyframe = 0;
+        sender->since_keyframe = 0;
+    } else {
+        sender->since_keyframe++;
+    }
+    sender->sequence++;
+
+    uint8_t* p = (uint8_t*)out;
+    p[0] = DELTA_MAGIC_0;
+    p[1] = DELTA_MAGIC_1;
+    p[2] = DELTA_VERSION;
+    p[3] = keyframe ? DELTA_KEYFRAME : 0;
+    wire_put_le32(p + 4, sender->sequence);
+    p = wire_put_varint(p + DELTA_HEADER_SIZE, (uint32_t)count);
+
+    for (int i = 0; i < count; i++) {
+        /* count <= DELTA_TABLE_SIZE and the table was reset if it could overflow */
+        int created;
+        delta_slot_t* slot = delta_lookup(sender, infos[i].bssid, &created);
+        uint8_t key = (uint8_t)(slot - sender->slots) | (created ? DELTA_KEY_NEW : 0);
+        p = delta_put_record(p, key, &slot->info, &infos[i]);
+    }
+
+    *out_size = (size_t)(p - (uint8_t*)out);
+    return 0;
+}
+
+/*
+ * delta_decode_snapshot
+ *  - input: delta_state_t *receiver, *buf, size, capacity of out_infos
+ *  - output: wifi_softap_info_t *out_infos, *out_count; receiver holds the snapshot
+ *  - return: 0 on success, -1 on failure (receiver then waits for a keyframe)
+ */
+int delta_decode_snapshot(delta_state_t* receiver, const void* buf, size_t size, wifi_softap_info_t* out_infos,
+                          int capacity, int* out_count) {
+    const uint8_t* p = (const uint8_t*)buf;
+    if (!receiver || !p || !out_infos || !out_count) return -1;
+
+    if (size < DELTA_HEADER_SIZE || p[0] != DELTA_MAGIC_0 || p[1] != DELTA_MAGIC_1 || p[2] != DELTA_VERSION) {
+        fprintf(stderr, "Delta decode failed: not a version %d delta message\n", DELTA_VERSION);
+        receiver->synced = 0;
+        return -1;
+    }
+    int keyframe = p[3] & DELTA_KEYFRAME;
+    uint32_t sequence = wire_get_le32(p + 4);
+
+    if (keyframe) {
+        delta_reset_table(receiver);
+    } else if (!receiver->synced || sequence != receiver->sequence + 1) {
+        fprintf(stderr, "Delta decode failed: sequence %u after %u, waiting for a keyframe\n", sequence,
+                receiver->sequence);
+        receiver->synced = 0;
+        return -1;
+    }
+    receiver->synced = 0; /* until the whole message is applied */
+
+    const uint8_t* end = p + size;
+    uint32_t count;
+    if (!(p = wire_get_varint(p + DELTA_HEADER_SIZE, end, WIRE_VARINT32_MAX, &count)) || count > (uint32_t)capacity) {
+        fprintf(stderr, "Delta decode failed: bad record count\n");
+        return -1;
+    }
+    for (uint32_t i = 0; i < count; i++) {
+        delta_slot_t* slot = NULL;
+        uint8_t key = 0;
+        if (p < end) {
+            key = *p++;
+            if (!(key & DELTA_KEY_NEW)) {
+                slot = &receiver->slots[key & DELTA_KEY_SLOT_MASK];
+                if (!slot->used) slot = NULL;
+            } else if (end - p >= WIFI_BT_MAC_ADDRESS_LEN) {
+                int created;
+                slot = delta_lookup(receiver, p, &created);
+                /* the sender put the AP in this slot, a different one means the tables differ */
+                if (slot && (!created || slot - receiver->slots != (key & DELTA_KEY_SLOT_MASK))) slot = NULL;
+                p += WIFI_BT_MAC_ADDRESS_LEN;
+            }
+        }
+        if (!slot || ((key & DELTA_KEY_CHANGED) && !(p = delta_get_record(p, end, &slot->info)))) {
+            fprintf(stderr, "Delta decode failed: malformed record %u\n", i);
+            return -1;
+        }
+        out_infos[i] = slot->info;
+    }
+    if (p != end) {
+        fprintf(stderr, "Delta decode failed: %zu trailing bytes\n", (size_t)(end - p));
+        return -1;
+    }
+
+    receiver->sequence = sequence;
+    receiver->synced = 1;
+    *out_count = (int)count;
+    return 0;
+}
+
+/* one-shot dispatch: every message a keyframe */
+static delta_state_t delta_dispatch_sender;
+static delta_state_t delta_dispatch_receiver;
+
+/*
+ * delta_encode
+ *  - input: wifi_softap_info_t *info
+ *  - output: *out_buffer, *out_size (a keyframe)
+ *  - return: 0 on success, -1 on failure
+ */
+int delta_encode(const wifi_softap_info_t* info, void* out_buffer, size_t* out_size) {
+    delta_request_keyframe(&delta_dispatch_sender);
+    return delta_encode_snapshot(&delta_dispatch_sender, info, 1, out_buffer, MAX_BUFFER, out_size);
+}
+
+/*
+ * delta_decode
+ *  - input: *buffer, size (a keyframe)
+ *  - output: wifi_softap_info_t *out_info
+ *  - return: 0 on success, -1 on failure
+ */
+int delta_decode(void* buffer, size_t size, wifi_softap_info_t* out_info) {
+    int count = 0;
+    delta_dispatch_receiver.synced = 0;
+    if (delta_decode_snapshot(&delta_dispatch_receiver, buffer, size, out_info, 1, &count) != 0) return -1;
+    if (count != 1) {
+        fprintf(stderr, "Delta decode failed: expected 1 record, got %d\n", count);
+        return -1;
+    }
+    return 0;
+}
+
+/*
+ * delta_encode_array
+ *  - input: wifi_softap_info_t *infos, int count
+ *  - output: *out_buffer, *out_size (a keyframe)
+ *  - return: 0 on success, -1 on failure
+ */
+int delta_encode_array(const wifi_softap_info_t* infos, int count, void* out_buffer, size_t* out_size) {
+    delta_request_keyframe(&delta_dispatch_sender);
+    return delta_encode_snapshot(&delta_dispatch_sender, infos, count, out_buffer, MAX_BUFFER, out_size);
+}
+
+/*
+ * delta_decode_array
+ *  - input: *buf, size (a keyframe)
+ *  - output: wifi_softap_info_t *out_infos (up to MAX_ARRAY), *out_count
+ *  - return: 0 on success, -1 on failure
+ */
+int delta_decode_array(void* buf, size_t size, wifi_softap_info_t* out_infos, int* out_count) {
+    delta_dispatch_receiver.synced = 0;
+    return delta_decode_snapshot(&delta_dispatch_receiver, buf, size, out_infos, MAX_ARRAY, out_count);
+}
+
+#endif /* DELTA_USAGE_H */
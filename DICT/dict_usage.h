@@ -0,0 +1,122 @@
+/* DICT/dict_usage.h
+ *
+ * Requires: nothing but sample_structure.h
+ * Exports:
+ *   int dict_build(dict_batch_t *dict, const wifi_softap_info_t *infos, int count);
+ *   dict_oui() / dict_nic()
+ *
+ * Notes:
+ * - Per-batch dictionaries for the array codecs (mpack_dict, flat_dict):
+ *   every distinct SSID and every distinct BSSID vendor prefix (OUI, the
+ *   first 3 bytes) of a batch gets an entry, records then refer to entries
+ *   (by index, or by ssid offset in flat) instead of carrying the bytes.
+ * - Entries are numbered in order of first appearance, entry e is the
+ *   ssid / OUI of infos[dict->ssid_first[e]] / infos[dict->oui_first[e]].
+ * - No allocation: a dict_batch_t holds the tables for up to
+ *   DICT_MAX_RECORDS records, only the part a batch needs is cleared.
+ */
+
+#ifndef DICT_USAGE_H
+#define DICT_USAGE_H
+
+#include "../sample_structure.h" /* defines wifi_softap_info_t, constants */
+
+#define DICT_MAX_RECORDS 1024
+#define DICT_OUI_LEN 3
+#define DICT_NIC_LEN (WIFI_BT_MAC_ADDRESS_LEN - DICT_OUI_LEN)
+#define DICT_HASH_SIZE (2 * DICT_MAX_RECORDS) /* power of two */
+
+typedef struct {
+    int count;      /* records of the batch */
+    int ssid_count; /* entries */
+    int oui_count;
+    uint16_t ssid_first[DICT_MAX_RECORDS]; /* entry -> first record with it */
+    uint16_t oui_first[DICT_MAX_RECORDS];
+    uint16_t ssid_ref[DICT_MAX_RECORDS];   /* record -> entry */
+    uint16_t oui_ref[DICT_MAX_RECORDS];
+    uint8_t ssid_len[DICT_MAX_RECORDS];    /* record -> ssid length */
+    /* open addressing, entry + 1, 0 is empty */
+    uint16_t ssid_hash[DICT_HASH_SIZE];
+    uint16_t oui_hash[DICT_HASH_SIZE];
+} dict_batch_t;
+
+static inline uint32_t dict_oui(const uint8_t* bssid) {
+    return (uint32_t)bssid[0] << 16 | (uint32_t)bssid[1] << 8 | bssid[2];
+}
+
+static inline const uint8_t* dict_nic(const uint8_t* bssid) {
+    return bssid + DICT_OUI_LEN;
+}
+
+/*
+ * Hash of the first and the last 8 bytes and the length: two loads however
+ * long the ssid is. Equal hashes are compared in full, so ssids that only
+ * differ in the middle just share a probe sequence.
+ */
+static inline uint32_t dict_ssid_hash(const char* ssid, size_t len) {
+    uint64_t head = 0, tail = 0;
+    if (len >= 8) {
+        memcpy(&head, ssid, 8);
+        memcpy(&tail, ssid + len - 8, 8);
+    } else {
+        memcpy(&head, ssid, len);
+    }
+    uint64_t hash = (head ^ (tail * 0x9e3779b97f4a7c15u) ^ len) * 0xff51afd7ed558ccdu;
+    return (uint32_t)(hash >> 32);
+}
+
+/*
+ * dict_build
+ *  - input: wifi_softap_info_t *infos, int count (1 to DICT_MAX_RECORDS)
+ *  - output: dict_batch_t *dict
+ *  - return: 0 on success, -1 on failure
+ */
+int dict_build(dict_batch_t* dict, const wifi_softap_info_t* infos, int count) {
+    if (!dict || !infos || count <= 0 || count > DICT_MAX_RECORDS) {
+        fprintf(stderr, "Dictionary build failed: %d records, at most %d\n", count, DICT_MAX_RECORDS);
+        return -1;
+    }
+
+    /* at least twice as many slots as records, so probes stay short */
+    uint32_t mask = 15;
+    while (mask + 1 < 2 * (uint32_t)count) mask = mask * 2 + 1;
+    memset(dict->ssid_hash, 0, (mask + 1) * sizeof(dict->ssid_hash[0]));
+    memset(dict->oui_hash, 0, (mask + 1) * sizeof(dict->oui_hash[0]));
+
+    dict->count = count;
+    dict->ssid_count = 0;
+    dict->oui_count = 0;
+    for (int i = 0; i < count; i++) {
+        const wifi_softap_info_t* info = &infos[i];
+        size_t len = strnlen(info->ssid, WIFI_SSID_MAX_LEN);
+        uint32_t hash = dict_ssid_hash(info->ssid, len);
+
+        uint16_t* slot;
+        for (slot = &dict->ssid_hash[hash & mask];; slot = &dict->ssid_hash[(++hash) & mask]) {
+            if (*slot == 0) {
+                dict->ssid_first[dict->ssid_count] = (uint16_t)i;
+                *slot = (uint16_t)++dict->ssid_count;
+                break;
+            }
+            int first = dict->ssid_first[*slot - 1];
+            if (dict->ssid_len[first] == len && memcmp(infos[first].ssid, info->ssid, len) == 0) break;
+        }
+        dict->ssid_ref[i] = (uint16_t)(*slot - 1);
+        dict->ssid_len[i] = (uint8_t)len;
+
+        uint32_t oui = dict_oui(info->bssid);
+        hash = (oui * 2654435761u) >> 16;
+        for (slot = &dict->oui_hash[hash & mask];; slot = &dict->oui_hash[(++hash) & mask]) {
+            if (*slot == 0) {
+                dict->oui_first[dict->oui_count] = (uint16_t)i;
+                *slot = (uint16_t)++dict->oui_count;
+                break;
+            }
+            if (dict_oui(infos[dict->oui_first[*slot - 1]].bssid) == oui) break;
+        }
+        dict->oui_ref[i] = (uint16_t)(*slot - 1);
+    }
+    return 0;
+}
+
+#endif /* DICT_USAGE_H */
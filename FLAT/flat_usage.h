@@ -0,0 +1,457 @@
+/* FLAT/flat_usage.h
+ *
+ * Requires: sample_structure.h, DICT/dict_usage.h, WIRE/wire_usage.h (in-tree format, no library)
+ * Exports:
+ *   int flat_encode(const wifi_softap_info_t *info, void *out_buffer, size_t *out_size);
+ *   int flat_decode(void *buffer, size_t size, wifi_softap_info_t *out_info);
+ *   int flat_encode_array(const wifi_softap_info_t *infos, int count, void *out_buffer, size_t *out_size);
+ *   int flat_decode_array(void *buf, size_t size, wifi_softap_info_t *out_infos, int *out_count);
+ *   int flat_encode_array_dict(const wifi_softap_info_t *infos, int count, void *out_buffer, size_t *out_size);
+ *   int flat_open(const void *buffer, size_t size, flat_table_t *out_table);
+ *   flat_record(), flat_get_*() and flat_lookup_*() accessors
+ *
+ * Notes:
+ * - Every record has the same size and every field a fixed offset, so a
+ *   field is read straight from the received buffer (flat_open + flat_get_*)
+ *   without decoding the record or the ones before it.
+ * - All integers are little-endian; on a little-endian host a load is a
+ *   plain unaligned read, the byte swap is only compiled on big-endian.
+ * - Layout: an 8 byte header, then a table of count records of `stride`
+ *   bytes. A single record is a table of one.
+ *     header: 'W' 'F' version(u8) flags(u8) count(u16) stride(u16)
+ *     record (FLAT_RECORD_SIZE = 76):
+ *        0 device_count (i32)      4 state (i32)      8 security (i32)
+ *       12 frequency (u16)        14 channel (u8)    15 ssid_len (u8)
+ *       16 ipv4 [4]               20 ipv6 [16]       36 bssid [6]
+ *       42 ssid [32], bytes past ssid_len are zero   74 padding [2]
+ * - stride may be larger than FLAT_RECORD_SIZE: a newer writer can append
+ *   fields to the record and this reader still finds the ones it knows.
+ * - FLAT_FLAG_DICT (flat_encode_array_dict): ssids and BSSID vendor
+ *   prefixes go to per-batch dictionaries after the table (DICT/dict_usage.h)
+ *   and the records refer to them by index:
+ *     record (FLAT_DICT_RECORD_SIZE = 44): bytes 0-35 as above,
+ *       36 ssid offset (u16)     38 OUI index (u16)  40 bssid[3..5]  43 padding
+ *     after the table: ssid_size (u16) oui_count (u16), oui_count OUIs [3],
+ *       ssid_size bytes of distinct ssids back to back
+ *   A record's ssid is ssid_len bytes at its offset, so records with the
+ *   same ssid share the bytes and resolving it is one bounds check.
+ *   flat_get_ssid() / flat_get_bssid() only fit the plain layout,
+ *   flat_lookup_ssid() / flat_lookup_bssid() read both. flat_decode*()
+ *   decode both. When the dictionaries would not make the batch smaller
+ *   (no repeats, or one record) the encoder writes the plain layout.
+ */
+
+#ifndef FLAT_USAGE_H
+#define FLAT_USAGE_H
+
+#include "../DICT/dict_usage.h"
+#include "../WIRE/wire_usage.h"
+#include "../sample_structure.h" /* defines wifi_softap_info_t, constants */
+
+#define FLAT_MAGIC_0 'W'
+#define FLAT_MAGIC_1 'F'
+#define FLAT_VERSION 1
+
+#define FLAT_HEADER_SIZE 8
+#define FLAT_RECORD_SIZE 76
+#define FLAT_DICT_RECORD_SIZE 44
+#define FLAT_DICT_COUNTS_SIZE 4
+
+#define FLAT_FLAG_DICT 0x01
+
+/* header */
+#define FLAT_OFF_MAGIC 0
+#define FLAT_OFF_VERSION 2
+#define FLAT_OFF_FLAGS 3
+#define FLAT_OFF_COUNT 4
+#define FLAT_OFF_STRIDE 6
+
+/* record */
+#define FLAT_OFF_DEVICE_COUNT 0
+#define FLAT_OFF_STATE 4
+#define FLAT_OFF_SECURITY 8
+#define FLAT_OFF_FREQUENCY 12
+#define FLAT_OFF_CHANNEL 14
+#define FLAT_OFF_SSID_LEN 15
+#define FLAT_OFF_IPV4 16
+#define FLAT_OFF_IPV6 20
+#define FLAT_OFF_BSSID 36
+#define FLAT_OFF_SSID 42
+
+/* FLAT_FLAG_DICT record */
+#define FLAT_OFF_SSID_OFFSET 36
+#define FLAT_OFF_OUI_INDEX 38
+#define FLAT_OFF_NIC 40
+
+typedef struct {
+    const uint8_t* records; /* first record, inside the received buffer */
+    int count;
+    size_t stride;
+    int flags;
+    /* FLAT_FLAG_DICT only */
+    size_t ssid_size;
+    int oui_count;
+    const uint8_t* ouis; /* oui_count * DICT_OUI_LEN */
+    const char* ssids;   /* ssid_size bytes */
+} flat_table_t;
+
+/* ---------- in-place accessors ---------- */
+/* record i of an opened table, i < table->count */
+static inline const uint8_t* flat_record(const flat_table_t* table, int i) {
+    return table->records + (size_t)i * table->stride;
+}
+
+static inline int flat_get_device_count(const uint8_t* record) {
+    return (int32_t)wire_get_le32(record + FLAT_OFF_DEVICE_COUNT);
+}
+
+static inline wifi_softap_state_t flat_get_state(const uint8_t* record) {
+    return (wifi_softap_state_t)(int32_t)wire_get_le32(record + FLAT_OFF_STATE);
+}
+
+static inline security_type_t flat_get_security(const uint8_t* record) {
+    return (security_type_t)(int32_t)wire_get_le32(record + FLAT_OFF_SECURITY);
+}
+
+static inline uint16_t flat_get_frequency(const uint8_t* record) {
+    return wire_get_le16(record + FLAT_OFF_FREQUENCY);
+}
+
+static inline uint8_t flat_get_channel(const uint8_t* record) {
+    return record[FLAT_OFF_CHANNEL];
+}
+
+/* IPV4_LEN / IPV6_LEN / WIFI_BT_MAC_ADDRESS_LEN bytes */
+static inline const uint8_t* flat_get_ipv4(const uint8_t* record) {
+    return record + FLAT_OFF_IPV4;
+}
+
+static inline const uint8_t* flat_get_ipv6(const uint8_t* record) {
+    return record + FLAT_OFF_IPV6;
+}
+
+static inline const uint8_t* flat_get_bssid(const uint8_t* record) {
+    return record + FLAT_OFF_BSSID;
+}
+
+/* not NUL-terminated, *out_len is clamped to WIFI_SSID_MAX_LEN */
+static inline const char* flat_get_ssid(const uint8_t* record, size_t* out_len) {
+    size_t len = record[FLAT_OFF_SSID_LEN];
+    *out_len = len > WIFI_SSID_MAX_LEN ? WIFI_SSID_MAX_LEN : len;
+    return (const char*)record + FLAT_OFF_SSID;
+}
+
+/* ssid of a record of either layout, NULL (*out_len 0) if it is not inside the ssids */
+static inline const char* flat_lookup_ssid(const flat_table_t* table, const uint8_t* record, size_t* out_len) {
+    if (!(table->flags & FLAT_FLAG_DICT)) return flat_get_ssid(record, out_len);
+
+    size_t offset = wire_get_le16(record + FLAT_OFF_SSID_OFFSET);
+    size_t len = record[FLAT_OFF_SSID_LEN];
+    if (len > WIFI_SSID_MAX_LEN || offset + len > table->ssid_size) {
+        *out_len = 0;
+        return NULL;
+    }
+    *out_len = len;
+    return table->ssids + offset;
+}
+
+/* bssid of a record of either layout into out, -1 if its OUI index is out of range */
+static inline int flat_lookup_bssid(const flat_table_t* table, const uint8_t* record, uint8_t* out) {
+    if (!(table->flags & FLAT_FLAG_DICT)) {
+        memcpy(out, flat_get_bssid(record), WIFI_BT_MAC_ADDRESS_LEN);
+        return 0;
+    }
+
+    int index = wire_get_le16(record + FLAT_OFF_OUI_INDEX);
+    if (index >= table->oui_count) return -1;
+    memcpy(out, table->ouis + DICT_OUI_LEN * index, DICT_OUI_LEN);
+    memcpy(out + DICT_OUI_LEN, record + FLAT_OFF_NIC, DICT_NIC_LEN);
+    return 0;
+}
+
+/* dictionaries after the table of a FLAT_FLAG_DICT buffer */
+static inline int flat_open_dict(const uint8_t* p, const uint8_t* end, flat_table_t* table) {
+    if (end - p < FLAT_DICT_COUNTS_SIZE) return -1;
+    table->ssid_size = wire_get_le16(p);
+    table->oui_count = wire_get_le16(p + 2);
+    p += FLAT_DICT_COUNTS_SIZE;
+    if ((size_t)(end - p) != DICT_OUI_LEN * (size_t)table->oui_count + table->ssid_size) return -1;
+
+    table->ouis = p;
+    table->ssids = (const char*)p + DICT_OUI_LEN * (size_t)table->oui_count;
+    return 0;
+}
+
+/*
+ * flat_open
+ *  - input: *buffer, size
+ *  - output: flat_table_t *out_table, pointing into buffer
+ *  - return: 0 on success, -1 on failure
+ * Checks the header and that the whole table is inside the buffer; the
+ * records themselves are only read by the accessors.
+ */
+int flat_open(const void* buffer, size_t size, flat_table_t* out_table) {
+    const uint8_t* p = (const uint8_t*)buffer;
+    if (!p || !out_table) return -1;
+
+    if (size < FLAT_HEADER_SIZE || p[FLAT_OFF_MAGIC] != FLAT_MAGIC_0 || p[FLAT_OFF_MAGIC + 1] != FLAT_MAGIC_1) {
+        fprintf(stderr, "Flat decode failed: not a flat buffer\n");
+        return -1;
+    }
+    if (p[FLAT_OFF_VERSION] != FLAT_VERSION) {
+        fprintf(stderr, "Flat decode failed: unsupported version %u\n", p[FLAT_OFF_VERSION]);
+        return -1;
+    }
+
+    int flags = p[FLAT_OFF_FLAGS];
+    if (flags & ~FLAT_FLAG_DICT) {
+        fprintf(stderr, "Flat decode failed: unknown flags 0x%02x\n", flags);
+        return -1;
+    }
+
+    size_t count = wire_get_le16(p + FLAT_OFF_COUNT);
+    size_t stride = wire_get_le16(p + FLAT_OFF_STRIDE);
+    size_t min_stride = (flags & FLAT_FLAG_DICT) ? FLAT_DICT_RECORD_SIZE : FLAT_RECORD_SIZE;
+    if (stride < min_stride || count > (size - FLAT_HEADER_SIZE) / stride) {
+        fprintf(stderr, "Flat decode failed: table does not fit the buffer\n");
+        return -1;
+    }
+
+    out_table->records = p + FLAT_HEADER_SIZE;
+    out_table->count = (int)count;
+    out_table->stride = stride;
+    out_table->flags = flags;
+    out_table->ssid_size = 0;
+    out_table->oui_count = 0;
+    if ((flags & FLAT_FLAG_DICT) && flat_open_dict(out_table->records + count * stride, p + size, out_table) != 0) {
+        fprintf(stderr, "Flat decode failed: bad dictionary\n");
+        return -1;
+    }
+    return 0;
+}
+
+/* ---------- flat encode / decode ---------- */
+static inline void flat_put_header(uint8_t* p, int count, int flags, size_t stride) {
+    p[FLAT_OFF_MAGIC] = FLAT_MAGIC_0;
+    p[FLAT_OFF_MAGIC + 1] = FLAT_MAGIC_1;
+    p[FLAT_OFF_VERSION] = FLAT_VERSION;
+    p[FLAT_OFF_FLAGS] = (uint8_t)flags;
+    wire_put_le16(p + FLAT_OFF_COUNT, (uint16_t)count);
+    wire_put_le16(p + FLAT_OFF_STRIDE, (uint16_t)stride);
+}
+
+/* bytes 0-35, the same in both layouts */
+static inline void flat_put_fixed(uint8_t* record, const wifi_softap_info_t* info, size_t ssid_len) {
+    wire_put_le32(record + FLAT_OFF_DEVICE_COUNT, (uint32_t)info->device_count);
+    wire_put_le32(record + FLAT_OFF_STATE, (uint32_t)info->state);
+    wire_put_le32(record + FLAT_OFF_SECURITY, (uint32_t)info->security);
+    wire_put_le16(record + FLAT_OFF_FREQUENCY, info->frequency);
+    record[FLAT_OFF_CHANNEL] = info->channel;
+    record[FLAT_OFF_SSID_LEN] = (uint8_t)ssid_len;
+    memcpy(record + FLAT_OFF_IPV4, info->ip_address.ipv4, IPV4_LEN);
+    memcpy(record + FLAT_OFF_IPV6, info->ip_address.ipv6, IPV6_LEN);
+}
+
+static inline void flat_put_record(uint8_t* record, const wifi_softap_info_t* info) {
+    size_t ssid_len = strnlen(info->ssid, WIFI_SSID_MAX_LEN);
+
+    flat_put_fixed(record, info, ssid_len);
+    memcpy(record + FLAT_OFF_BSSID, info->bssid, WIFI_BT_MAC_ADDRESS_LEN);
+    /* fixed size ssid slot: zero the tail so the bytes sent don't depend on stale memory */
+    memcpy(record + FLAT_OFF_SSID, info->ssid, ssid_len);
+    memset(record + FLAT_OFF_SSID + ssid_len, 0, FLAT_RECORD_SIZE - FLAT_OFF_SSID - ssid_len);
+}
+
+static inline void flat_get_fixed(const uint8_t* record, wifi_softap_info_t* info) {
+    info->device_count = flat_get_device_count(record);
+    info->state = flat_get_state(record);
+    memcpy(info->ip_address.ipv4, flat_get_ipv4(record), IPV4_LEN);
+    memcpy(info->ip_address.ipv6, flat_get_ipv6(record), IPV6_LEN);
+    info->security = flat_get_security(record);
+    info->channel = flat_get_channel(record);
+    info->frequency = flat_get_frequency(record);
+}
+
+static inline void flat_get_record(const uint8_t* record, wifi_softap_info_t* info) {
+    size_t ssid_len;
+    const char* ssid = flat_get_ssid(record, &ssid_len);
+
+    flat_get_fixed(record, info);
+    memcpy(info->ssid, ssid, ssid_len);
+    info->ssid[ssid_len] = '\0';
+    memcpy(info->bssid, flat_get_bssid(record), WIFI_BT_MAC_ADDRESS_LEN);
+}
+
+static inline int flat_get_record_dict(const flat_table_t* table, const uint8_t* record, wifi_softap_info_t* info) {
+    size_t ssid_len;
+    const char* ssid = flat_lookup_ssid(table, record, &ssid_len);
+    if (!ssid || flat_lookup_bssid(table, record, info->bssid) != 0) {
+        fprintf(stderr, "Flat decode failed: dictionary reference out of range\n");
+        return -1;
+    }
+
+    flat_get_fixed(record, info);
+    /* one fixed-size copy unless the ssid is near the end of the buffer */
+    if ((size_t)(ssid - table->ssids) + WIFI_SSID_MAX_LEN <= table->ssid_size) {
+        memcpy(info->ssid, ssid, WIFI_SSID_MAX_LEN);
+    } else {
+        memcpy(info->ssid, ssid, ssid_len);
+    }
+    info->ssid[ssid_len] = '\0';
+    return 0;
+}
+
+/* all records of an opened table, either layout */
+static inline int flat_get_table(const flat_table_t* table, wifi_softap_info_t* out_infos) {
+    if (table->flags & FLAT_FLAG_DICT) {
+        for (int i = 0; i < table->count; i++) {
+            if (flat_get_record_dict(table, flat_record(table, i), &out_infos[i]) != 0) return -1;
+        }
+        return 0;
+    }
+    for (int i = 0; i < table->count; i++) {
+        flat_get_record(flat_record(table, i), &out_infos[i]);
+    }
+    return 0;
+}
+
+/*
+ * flat_encode_array
+ *  - input: wifi_softap_info_t *infos, int count
+ *  - output: *out_buffer, *out_size
+ *  - return: 0 on success, -1 on failure
+ */
+int flat_encode_array(const wifi_softap_info_t* infos, int count, void* out_buffer, size_t* out_size) {
+    if (!infos || count <= 0 || !out_buffer || !out_size) return -1;
+
+    size_t size = FLAT_HEADER_SIZE + (size_t)count * FLAT_RECORD_SIZE;
+    if (count > UINT16_MAX || size > MAX_BUFFER) {
+        fprintf(stderr, "Flat encode failed: %d records do not fit\n", count);
+        return -1;
+    }
+
+    uint8_t* p = (uint8_t*)out_buffer;
+    flat_put_header(p, count, 0, FLAT_RECORD_SIZE);
+    p += FLAT_HEADER_SIZE;
+    for (int i = 0; i < count; i++) {
+        flat_put_record(p, &infos[i]);
+        p += FLAT_RECORD_SIZE;
+    }
+
+    *out_size = size;
+    return 0;
+}
+
+/*
+ * flat_decode_array
+ *  - input: *buf, size
+ *  - output: wifi_softap_info_t *out_infos (up to MAX_ARRAY), *out_count
+ *  - return: 0 on success, -1 on failure
+ */
+int flat_decode_array(void* buf, size_t size, wifi_softap_info_t* out_infos, int* out_count) {
+    flat_table_t table;
+    if (!buf || size == 0 || !out_infos || !out_count) return -1;
+    if (flat_open(buf, size, &table) != 0) return -1;
+    if (table.count > MAX_ARRAY) {
+        fprintf(stderr, "Flat decode failed: %d records, more than %d\n", table.count, MAX_ARRAY);
+        return -1;
+    }
+
+    if (flat_get_table(&table, out_infos) != 0) return -1;
+    *out_count = table.count;
+    return 0;
+}
+
+static dict_batch_t flat_dict_batch;
+
+/*
+ * flat_encode_array_dict
+ *  - input: wifi_softap_info_t *infos, int count
+ *  - output: *out_buffer, *out_size, FLAT_FLAG_DICT layout, or the plain
+ *    one if the dictionaries would not make the batch smaller
+ *  - return: 0 on success, -1 on failure
+ */
+int flat_encode_array_dict(const wifi_softap_info_t* infos, int count, void* out_buffer, size_t* out_size) {
+    if (!infos || count <= 0 || !out_buffer || !out_size) return -1;
+
+    dict_batch_t* dict = &flat_dict_batch;
+    if (dict_build(dict, infos, count) != 0) return -1;
+
+    /* entry e of the ssid dictionary starts at ssid_offset[e] */
+    uint16_t ssid_offset[DICT_MAX_RECORDS];
+    size_t ssid_size = 0;
+    for (int e = 0; e < dict->ssid_count; e++) {
+        ssid_offset[e] = (uint16_t)ssid_size;
+        ssid_size += dict->ssid_len[dict->ssid_first[e]];
+    }
+    size_t size = FLAT_HEADER_SIZE + (size_t)count * FLAT_DICT_RECORD_SIZE + FLAT_DICT_COUNTS_SIZE +
+                  DICT_OUI_LEN * (size_t)dict->oui_count + ssid_size;
+    /* no smaller than the plain layout: send that one, FLAT_FLAG_DICT clear */
+    if (size >= FLAT_HEADER_SIZE + (size_t)count * FLAT_RECORD_SIZE) {
+        return flat_encode_array(infos, count, out_buffer, out_size);
+    }
+    /* ssids are copied WIFI_SSID_MAX_LEN bytes at a time, the last one may
+     * write that far past size */
+    if (size + WIFI_SSID_MAX_LEN > MAX_BUFFER) {
+        fprintf(stderr, "Flat encode failed: %d records do not fit\n", count);
+        return -1;
+    }
+
+    uint8_t* p = (uint8_t*)out_buffer;
+    flat_put_header(p, count, FLAT_FLAG_DICT, FLAT_DICT_RECORD_SIZE);
+    p += FLAT_HEADER_SIZE;
+    for (int i = 0; i < count; i++) {
+        flat_put_fixed(p, &infos[i], dict->ssid_len[i]);
+        wire_put_le16(p + FLAT_OFF_SSID_OFFSET, ssid_offset[dict->ssid_ref[i]]);
+        wire_put_le16(p + FLAT_OFF_OUI_INDEX, dict->oui_ref[i]);
+        memcpy(p + FLAT_OFF_NIC, dict_nic(infos[i].bssid), DICT_NIC_LEN);
+        p[FLAT_DICT_RECORD_SIZE - 1] = 0;
+        p += FLAT_DICT_RECORD_SIZE;
+    }
+
+    wire_put_le16(p, (uint16_t)ssid_size);
+    wire_put_le16(p + 2, (uint16_t)dict->oui_count);
+    p += FLAT_DICT_COUNTS_SIZE;
+    for (int e = 0; e < dict->oui_count; e++) {
+        memcpy(p, infos[dict->oui_first[e]].bssid, DICT_OUI_LEN);
+        p += DICT_OUI_LEN;
+    }
+    for (int e = 0; e < dict->ssid_count; e++) {
+        int first = dict->ssid_first[e];
+        memcpy(p, infos[first].ssid, WIFI_SSID_MAX_LEN);
+        p += dict->ssid_len[first];
+    }
+
+    *out_size = size;
+    return 0;
+}
+
+/*
+ * flat_encode
+ *  - input: wifi_softap_info_t *info
+ *  - output: *out_buffer, *out_size
+ *  - return: 0 on success, -1 on failure
+ */
+int flat_encode(const wifi_softap_info_t* info, void* out_buffer, size_t* out_size) {
+    return flat_encode_array(info, 1, out_buffer, out_size);
+}
+
+/*
+ * flat_decode
+ *  - input: *buffer, size
+ *  - output: wifi_softap_info_t *out_info
+ *  - return: 0 on success, -1 on failure
+ */
+int flat_decode(void* buffer, size_t size, wifi_softap_info_t* out_info) {
+    flat_table_t table;
+    if (!buffer || size == 0 || !out_info) return -1;
+    if (flat_open(buffer, size, &table) != 0) return -1;
+    if (table.count != 1) {
+        fprintf(stderr, "Flat decode failed: expected 1 record, got %d\n", table.count);
+        return -1;
+    }
+
+    return flat_get_table(&table, out_info);
+}
+
+#endif /* FLAT_USAGE_H */
@@ -0,0 +1,259 @@
+/* LZ/lz_usage.h
+ *
+ * Requires: nothing (in-tree, no library)
+ * Exports:
+ *   size_t lz_compress_bound(size_t size);
+ *   int lz_compress(const void *src, size_t size, void *dst, size_t capacity, size_t *out_size);
+ *   int lz_decompress(const void *src, size_t size, void *dst, size_t capacity, size_t *out_size);
+ *
+ * Notes:
+ * - LZ77 block compressor for frame payloads, in the LZ4 block layout: a
+ *   block is a run of sequences
+ *     token (u8)     high 4 bits literal count, low 4 bits match length - 4,
+ *                    15 means more: add bytes until one is not 255
+ *     literals       literal count bytes
+ *     offset (u16 LE) distance back to the match, 1 to LZ_MAX_OFFSET
+ *     match length   the 255-continuation of the low nibble
+ *   and the last sequence is literals only (no offset).
+ * - Blocks keep the LZ4 end-of-block rules, so LZ4_decompress_safe() reads
+ *   them: the last LZ_LAST_LITERALS bytes are literals and the last match
+ *   starts at least LZ_MF_LIMIT bytes before the end (inputs shorter than
+ *   LZ_MF_LIMIT + 1 are all literals). lz_decompress does not require them.
+ * - One pass, greedy: a hash of the next 4 bytes finds the last position
+ *   with the same hash, a match is taken if it is at least LZ_MIN_MATCH
+ *   bytes. Bytes without a match make the scan step grow, so data that does
+ *   not compress is skipped quickly.
+ * - Inputs up to LZ_MAX_INPUT bytes, the hash table holds 16-bit positions
+ *   and is sized (and cleared) for the input.
+ * - lz_decompress checks every length and offset against both buffers, a
+ *   malformed block is an error, never an out-of-bounds access.
+ * - lz_compress is not reentrant: its hash table is static. Callers on
+ *   more than one thread need their own copy or a lock.
+ */
+
+#ifndef LZ_USAGE_H
+#define LZ_USAGE_H
+
+#include <stdint.h>
+#include <stdio.h>
+#include <string.h>
+
+#define LZ_MIN_MATCH 4
+#define LZ_LAST_LITERALS 5 /* LZ4: a block ends with at least 5 literals */
+#define LZ_MF_LIMIT 12     /* LZ4: no match starts in the last 12 bytes */
+#define LZ_MAX_OFFSET 65535
+#define LZ_MAX_INPUT 65535
+#define LZ_HASH_BITS_MIN 8
+#define LZ_HASH_BITS_MAX 12
+#define LZ_SKIP_SHIFT 5 /* step grows by 1 every 32 bytes without a match */
+/* lz_compress_bound() as a constant expression, for static buffers */
+#define LZ_COMPRESS_BOUND(size) ((size) + (size) / 255 + 16)
+
+static inline uint32_t lz_load_u32(const uint8_t* p) {
+    uint32_t value;
+    memcpy(&value, p, sizeof(value));
+    return value;
+}
+
+static inline uint64_t lz_load_u64(const uint8_t* p) {
+    uint64_t value;
+    memcpy(&value, p, sizeof(value));
+    return value;
+}
+
+/* bytes from p equal to the bytes from ref, p up to end; 8 at a time */
+static inline size_t lz_count_match(const uint8_t* p, const uint8_t* ref, const uint8_t* end) {
+    const uint8_t* start = p;
+    while (end - p >= 8) {
+        uint64_t diff = lz_load_u64(p) ^ lz_load_u64(ref);
+        if (diff) {
+#if defined(__BYTE_ORDER__) && __BYTE_ORDER__ == __ORDER_BIG_ENDIAN__
+            return (size_t)(p - start) + (__builtin_clzll(diff) >> 3);
+#else
+            return (size_t)(p - start) + (__builtin_ctzll(diff) >> 3);
+#endif
+        }
+        p += 8;
+        ref += 8;
+    }
+    while (p < end && *p == *ref) {
+        p++;
+        ref++;
+    }
+    return (size_t)(p - start);
+}
+
+static inline uint32_t lz_hash(uint32_t value, int bits) {
+    return (value * 2654435761u) >> (32 - bits);
+}
+
+/* 15 in the nibble, then 255s and the remainder */
+static inline uint8_t* lz_put_length(uint8_t* p, size_t length) {
+    while (length >= 255) {
+        *p++ = 255;
+        length -= 255;
+    }
+    *p++ = (uint8_t)length;
+    return p;
+}
+
+/* NULL if the length runs past end */
+static inline const uint8_t* lz_get_length(const uint8_t* p, const uint8_t* end, size_t* length) {
+    uint8_t byte;
+    do {
+        if (p >= end) return NULL;
+        byte = *p++;
+        *length += byte;
+    } while (byte == 255);
+    return p;
+}
+
+/* one sequence: token, literals, and the match unless match_length is 0 */
+static inline uint8_t* lz_put_sequence(uint8_t* op, const uint8_t* literals, size_t literal_count,
+                                       size_t offset, size_t match_length) {
+    uint8_t* token = op++;
+    size_t match_code = match_length ? match_length - LZ_MIN_MATCH : 0;
+
+    *token = (uint8_t)((literal_count >= 15 ? 15 : literal_count) << 4);
+    if (literal_count >= 15) op = lz_put_length(op, literal_count - 15);
+    memcpy(op, literals, literal_count);
+    op += literal_count;
+    if (!match_length) return op;
+
+    *op++ = (uint8_t)offset;
+    *op++ = (uint8_t)(offset >> 8);
+    *token |= (uint8_t)(match_code >= 15 ? 15 : match_code);
+    if (match_code >= 15) op = lz_put_length(op, match_code - 15);
+    return op;
+}
+
+/*
+ * lz_compress_bound
+ *  - return: the largest block lz_compress can write for size input bytes
+ */
+size_t lz_compress_bound(size_t size) {
+    return LZ_COMPRESS_BOUND(size);
+}
+
+/*
+ * lz_compress
+ *  - input: *src, size (at most LZ_MAX_INPUT)
+ *  - output: *dst (capacity bytes), *out_size
+ *  - return: 0 on success, -1 on failure (also when capacity is less than
+ *    lz_compress_bound(size), so callers sending the smaller of the two
+ *    pass a capacity of the bound and compare)
+ */
+int lz_compress(const void* src, size_t size, void* dst, size_t capacity, size_t* out_size) {
+    static uint16_t table[1 << LZ_HASH_BITS_MAX];
+
+    if (!src || !dst || !out_size || size > LZ_MAX_INPUT) return -1;
+    if (capacity < lz_compress_bound(size)) {
+        fprintf(stderr, "LZ compress failed: %zu bytes of output for %zu of input\n", capacity, size);
+        return -1;
+    }
+
+    const uint8_t* base = (const uint8_t*)src;
+    const uint8_t* end = base + size;
+    const uint8_t* anchor = base; /* first literal not yet written */
+    uint8_t* op = (uint8_t*)dst;
+
+    /* shorter inputs have no room for a match before the end-of-block literals */
+    if (size > LZ_MF_LIMIT) {
+        int bits = LZ_HASH_BITS_MIN;
+        while (bits < LZ_HASH_BITS_MAX && ((size_t)1 << bits) < size) bits++;
+        memset(table, 0, sizeof(table[0]) << bits);
+
+        const uint8_t* match_limit = end - LZ_MF_LIMIT;  /* last position a match starts at */
+        const uint8_t* match_end_limit = end - LZ_LAST_LITERALS;
+        const uint8_t* ip = base + 1; /* position 0 is the empty slot value */
+        unsigned misses = 1 << LZ_SKIP_SHIFT;
+        while (ip <= match_limit) {
+            uint32_t sequence = lz_load_u32(ip);
+            uint32_t h = lz_hash(sequence, bits);
+            const uint8_t* ref = base + table[h];
+            table[h] = (uint16_t)(ip - base);
+
+            if (ref == base || lz_load_u32(ref) != sequence) {
+                ip += misses++ >> LZ_SKIP_SHIFT;
+                continue;
+            }
+
+            /* extend backwards over pending literals, then forwards */
+            while (ip > anchor && ref > base && ip[-1] == ref[-1]) {
+                ip--;
+                ref--;
+            }
+            size_t match_length =
+                LZ_MIN_MATCH + lz_count_match(ip + LZ_MIN_MATCH, ref + LZ_MIN_MATCH, match_end_limit);
+            const uint8_t* match_end = ip + match_length;
+            op = lz_put_sequence(op, anchor, (size_t)(ip - anchor), (size_t)(ip - ref), match_length);
+            anchor = ip = match_end;
+            misses = 1 << LZ_SKIP_SHIFT;
+            /* a position inside the match, so the next repeat can refer to it */
+            if (ip - 2 <= match_limit) table[lz_hash(lz_load_u32(ip - 2), bits)] = (uint16_t)(ip - 2 - base);
+        }
+    }
+
+    op = lz_put_sequence(op, anchor, (size_t)(end - anchor), 0, 0);
+    *out_size = (size_t)(op - (uint8_t*)dst);
+    return 0;
+}
+
+/*
+ * lz_decompress
+ *  - input: *src, size, one block from lz_compress
+ *  - output: *dst (capacity bytes), *out_size
+ *  - return: 0 on success, -1 on failure
+ */
+int lz_decompress(const void* src, size_t size, void* dst, size_t capacity, size_t* out_size) {
+    if (!src || !dst || !out_size) return -1;
+
+    const uint8_t* ip = (const uint8_t*)src;
+    const uint8_t* end = ip + size;
+    uint8_t* base = (uint8_t*)dst;
+    uint8_t* op = base;
+    uint8_t* op_end = base + capacity;
+
+    while (ip < end) {
+        uint8_t token = *ip++;
+
+        size_t literal_count = token >> 4;
+        if (literal_count == 15 && !(ip = lz_get_length(ip, end, &literal_count))) break;
+        if (literal_count > (size_t)(end - ip) || literal_count > (size_t)(op_end - op)) break;
+        /* short runs as one fixed-size copy when both buffers have room */
+        if (literal_count <= 16 && end - ip >= 16 && op_end - op >= 16) {
+            memcpy(op, ip, 16);
+        } else {
+            memcpy(op, ip, literal_count);
+        }
+        ip += literal_count;
+        op += literal_count;
+        if (ip == end) {
+            *out_size = (size_t)(op - base);
+            return 0;
+        }
+
+        if (end - ip < 2) break;
+        size_t offset = ip[0] | (size_t)ip[1] << 8;
+        ip += 2;
+        size_t match_length = token & 15;
+        if (match_length == 15 && !(ip = lz_get_length(ip, end, &match_length))) break;
+        match_length += LZ_MIN_MATCH;
+        if (offset == 0 || offset > (size_t)(op - base) || match_length > (size_t)(op_end - op)) break;
+
+        const uint8_t* ref = op - offset;
+        if (offset >= 8 && (size_t)(op_end - op) >= match_length + 8) {
+            /* 8 bytes at a time, each chunk reads bytes already written */
+            for (size_t i = 0; i < match_length; i += 8) memcpy(op + i, ref + i, 8);
+            op += match_length;
+        } else {
+            /* overlapping or at the end: byte by byte, the match repeats the last offset bytes */
+            for (size_t i = 0; i < match_length; i++) *op++ = *ref++;
+        }
+    }
+
+    fprintf(stderr, "LZ decompress failed: malformed block\n");
+    return -1;
+}
+
+#endif /* LZ_USAGE_H */
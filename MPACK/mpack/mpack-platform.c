@@ -138,11 +138,39 @@ void mpack_break_hit(const char* message) {
 
 // The below are adapted from the C wikibook:
 //     https://en.wikibooks.org/wiki/C_Programming/Strings
+//
+// These are only compiled when neither the stdlib nor the compiler builtins
+// are available (MPACK_STDLIB=0 with MPACK_NO_BUILTINS, or a non-GNU
+// compiler.) Under GCC and Clang they work a machine word at a time using
+// unaligned, may_alias word types. Sizes between 4 and 16 bytes, which
+// covers the fixed ipv4/ipv6/bssid bins, are copied with two overlapping
+// loads and stores and no loop. Other compilers keep the byte loops.
+
+#if defined(__GNUC__) || defined(__clang__)
+    #define MPACK_WORD_MEMFUNCS 1
+    typedef size_t __attribute__((__may_alias__, __aligned__(1))) mpack_uword_t;
+    typedef uint32_t __attribute__((__may_alias__, __aligned__(1))) mpack_u32word_t;
+    typedef size_t __attribute__((__may_alias__)) mpack_aword_t;
+    #define MPACK_WORD_SIZE sizeof(size_t)
+    #define MPACK_WORD_ONES ((size_t)-1 / 0xFF)
+    #define MPACK_WORD_HIGHS (MPACK_WORD_ONES * 0x80)
+#else
+    #define MPACK_WORD_MEMFUNCS 0
+#endif
 
 #ifndef mpack_memcmp
 int mpack_memcmp(const void* s1, const void* s2, size_t n) {
      const unsigned char *us1 = (const unsigned char *) s1;
      const unsigned char *us2 = (const unsigned char *) s2;
+     #if MPACK_WORD_MEMFUNCS
+     // skip equal words; a mismatching word is resolved by the byte loop
+     while (n >= MPACK_WORD_SIZE &&
+             *(const mpack_uword_t*)us1 == *(const mpack_uword_t*)us2) {
+         us1 += MPACK_WORD_SIZE;
+         us2 += MPACK_WORD_SIZE;
+         n -= MPACK_WORD_SIZE;
+     }
+     #endif
      while (n-- != 0) {
          if (*us1 != *us2)
              return (*us1 < *us2) ? -1 : +1;
@@ -157,6 +185,29 @@ int mpack_memcmp(const void* s1, const void* s2, size_t n) {
 void* mpack_memcpy(void* MPACK_RESTRICT s1, const void* MPACK_RESTRICT s2, size_t n) {
     char* MPACK_RESTRICT dst = (char *)s1;
     const char* MPACK_RESTRICT src = (const char *)s2;
+    #if MPACK_WORD_MEMFUNCS
+    if (n >= MPACK_WORD_SIZE) {
+        // head and tail words may overlap; the tail store rewrites the
+        // same bytes so no remainder loop is needed
+        mpack_uword_t tail = *(const mpack_uword_t*)(src + n - MPACK_WORD_SIZE);
+        char* dst_tail = dst + n - MPACK_WORD_SIZE;
+        while (n > MPACK_WORD_SIZE) {
+            *(mpack_uword_t*)dst = *(const mpack_uword_t*)src;
+            dst += MPACK_WORD_SIZE;
+            src += MPACK_WORD_SIZE;
+            n -= MPACK_WORD_SIZE;
+        }
+        *(mpack_uword_t*)dst_tail = tail;
+        return s1;
+    }
+    if (n >= sizeof(uint32_t)) {
+        mpack_u32word_t head = *(const mpack_u32word_t*)src;
+        mpack_u32word_t tail = *(const mpack_u32word_t*)(src + n - sizeof(uint32_t));
+        *(mpack_u32word_t*)dst = head;
+        *(mpack_u32word_t*)(dst + n - sizeof(uint32_t)) = tail;
+        return s1;
+    }
+    #endif
     while (n-- != 0)
         *dst++ = *src++;
     return s1;
@@ -183,6 +234,19 @@ void* mpack_memmove(void* s1, const void* s2, size_t n) {
 void* mpack_memset(void* s, int c, size_t n) {
     unsigned char *us = (unsigned char *)s;
     unsigned char uc = (unsigned char)c;
+    #if MPACK_WORD_MEMFUNCS
+    if (n >= MPACK_WORD_SIZE) {
+        size_t word = MPACK_WORD_ONES * uc;
+        unsigned char* us_tail = us + n - MPACK_WORD_SIZE;
+        while (n > MPACK_WORD_SIZE) {
+            *(mpack_uword_t*)us = word;
+            us += MPACK_WORD_SIZE;
+            n -= MPACK_WORD_SIZE;
+        }
+        *(mpack_uword_t*)us_tail = word;
+        return s;
+    }
+    #endif
     while (n-- != 0)
         *us++ = uc;
     return s;
@@ -192,6 +256,21 @@ void* mpack_memset(void* s, int c, size_t n) {
 #ifndef mpack_strlen
 size_t mpack_strlen(const char* s) {
     const char* p = s;
+    #if MPACK_WORD_MEMFUNCS
+    // byte steps up to word alignment, then aligned word reads (which
+    // cannot cross a page boundary) until a word contains a zero byte
+    while (((uintptr_t)p & (MPACK_WORD_SIZE - 1)) != 0) {
+        if (*p == '\0')
+            return (size_t)(p - s);
+        p++;
+    }
+    for (;;) {
+        size_t word = *(const mpack_aword_t*)p;
+        if (((word - MPACK_WORD_ONES) & ~word & MPACK_WORD_HIGHS) != 0)
+            break;
+        p += MPACK_WORD_SIZE;
+    }
+    #endif
     while (*p != '\0')
         p++;
     return (size_t)(p - s);
@@ -4,10 +4,28 @@
  * Exports:
  *   int mpack_encode(wifi_softap_info_t *info, void *out_buffer, size_t *out_size);
  *   int mpack_decode(void *buffer, size_t size, wifi_softap_info_t *out_info);
+ *   int mpack_decode_node(void *buffer, size_t size, wifi_softap_info_t *out_info);
+ *   int mpack_encode_map(wifi_softap_info_t *info, void *out_buffer, size_t *out_size);
+ *   int mpack_decode_map(void *buffer, size_t size, wifi_softap_info_t *out_info);
+ *   int mpack_encode_dict(const wifi_softap_info_t *info, void *out_buffer, size_t *out_size);
+ *   int mpack_decode_dict(void *buffer, size_t size, wifi_softap_info_t *out_info);
+ *   int mpack_encode_array_dict(const wifi_softap_info_t *infos, int count, void *out_buffer, size_t *out_size);
+ *   int mpack_decode_array_dict(void *buffer, size_t size, wifi_softap_info_t *out_infos, int *out_count);
+ *   int mpack_encode_paged(const wifi_softap_info_t *info, mpack_page_chain_t *out_chain);
+ *   int mpack_encode_array_paged(const wifi_softap_info_t *infos, int count, mpack_page_chain_t *out_chain);
+ *   int mpack_send_pages(const char *host, const char *portstr, mpack_page_chain_t *chain);
  *
  * Notes:
  * - This implementation uses MPack buffer writer (mpack_writer_init)
  *   and MPack reader (mpack_reader_init_data).
+ * - The *_node decoders use the node API instead: the message is parsed
+ *   once into a static node pool (mpack_tree_init_pool, no allocation) and
+ *   fields are then read by index, in any order.
+ * - The *_map functions use a keyed-map schema instead, see below.
+ * - The *_dict functions send ssids and BSSID vendor prefixes once per
+ *   array and refer to them by index, see below.
+ * - The *_paged functions write into a chain of pool pages, so the output
+ *   is not bounded by MAX_BUFFER, see below.
  * - Schema: array of 9 elements in this exact order:
  *     [ device_count (int32),
  *       state (int32),
@@ -24,14 +42,29 @@
 #define MPACK_USAGE_H
 
 #include "../sample_structure.h" /* defines wifi_softap_info_t, constants */
+#include "../DICT/dict_usage.h"
 #include "mpack/mpack.h"
 
+/* field positions in the 9-element record array */
+enum {
+    MPACK_FIELD_DEVICE_COUNT = 0,
+    MPACK_FIELD_STATE,
+    MPACK_FIELD_IPV4,
+    MPACK_FIELD_IPV6,
+    MPACK_FIELD_SSID,
+    MPACK_FIELD_BSSID,
+    MPACK_FIELD_SECURITY,
+    MPACK_FIELD_CHANNEL,
+    MPACK_FIELD_FREQUENCY,
+    MPACK_FIELD_COUNT
+};
+
 /* Helper function to write a single wifi_softap_info_t structure */
 int write_single_structure(mpack_writer_t* writer, const wifi_softap_info_t* info) {
     if (!writer || !info) return -1;
 
     /* write an array of 9 elements (fixed-order schema) */
-    mpack_start_array(writer, 9);
+    mpack_start_array(writer, MPACK_FIELD_COUNT);
 
     mpack_write_i32(writer, (int32_t)info->device_count);
     mpack_write_i32(writer, (int32_t)info->state);
@@ -56,48 +89,306 @@ int write_single_structure(mpack_writer_t* writer, const wifi_softap_info_t* inf
     return 0;
 }
 
+/* ---------- schema-compiled writer ---------- */
+/*
+ * Largest encoded record: fixarray tag, 3 x int32 (5 bytes each), 4 bin8
+ * headers with the ipv4/ipv6/ssid/bssid payloads, uint8 (2) and uint16 (3).
+ */
+#define MPACK_RECORD_MAX_SIZE (1 + 3 * 5 + 4 * 2 + IPV4_LEN + IPV6_LEN + WIFI_SSID_MAX_LEN + WIFI_BT_MAC_ADDRESS_LEN + 2 + 3)
+
+/* smallest encoding of an unsigned int, same choice as mpack_write_u32 */
+static inline char* mpack_put_u32(char* p, uint32_t value) {
+    if (value <= 127) {
+        *p = (char)value;
+        return p + 1;
+    } else if (value <= UINT8_MAX) {
+        p[0] = (char)0xcc;
+        mpack_store_u8(p + 1, (uint8_t)value);
+        return p + 2;
+    } else if (value <= UINT16_MAX) {
+        p[0] = (char)0xcd;
+        mpack_store_u16(p + 1, (uint16_t)value);
+        return p + 3;
+    }
+    p[0] = (char)0xce;
+    mpack_store_u32(p + 1, value);
+    return p + 5;
+}
+
+/* smallest encoding of a signed int, same choice as mpack_write_i32 */
+static inline char* mpack_put_i32(char* p, int32_t value) {
+    if (value >= 0) {
+        return mpack_put_u32(p, (uint32_t)value);
+    } else if (value >= -32) {
+        *p = (char)(int8_t)value;
+        return p + 1;
+    } else if (value >= INT8_MIN) {
+        p[0] = (char)0xd0;
+        mpack_store_i8(p + 1, (int8_t)value);
+        return p + 2;
+    } else if (value >= INT16_MIN) {
+        p[0] = (char)0xd1;
+        mpack_store_i16(p + 1, (int16_t)value);
+        return p + 3;
+    }
+    p[0] = (char)0xd2;
+    mpack_store_i32(p + 1, value);
+    return p + 5;
+}
+
+/* bin8 header with a length known at compile time, then the payload */
+static inline char* mpack_put_bin8(char* p, const void* data, uint8_t len) {
+    p[0] = (char)0xc4;
+    p[1] = (char)len;
+    memcpy(p + 2, data, len);
+    return p + 2 + len;
+}
+
+/* one record, at most MPACK_RECORD_MAX_SIZE bytes, no checks */
+static inline char* mpack_put_record(char* p, const wifi_softap_info_t* info) {
+    *p++ = (char)(0x90 | MPACK_FIELD_COUNT); /* fixarray of 9 */
+    p = mpack_put_i32(p, (int32_t)info->device_count);
+    p = mpack_put_i32(p, (int32_t)info->state);
+    p = mpack_put_bin8(p, info->ip_address.ipv4, IPV4_LEN);
+    p = mpack_put_bin8(p, info->ip_address.ipv6, IPV6_LEN);
+    p = mpack_put_bin8(p, info->ssid, (uint8_t)strnlen(info->ssid, WIFI_SSID_MAX_LEN));
+    p = mpack_put_bin8(p, info->bssid, WIFI_BT_MAC_ADDRESS_LEN);
+    p = mpack_put_i32(p, (int32_t)info->security);
+    p = mpack_put_u32(p, info->channel);
+    p = mpack_put_u32(p, info->frequency);
+    return p;
+}
+
+/*
+ * write_single_structure_compiled
+ *  - same bytes as write_single_structure, but the array tag and the fixed
+ *    ipv4/ipv6/bssid bin headers are constants and only the ints, ssid and
+ *    frequency need a size choice
+ *  - one capacity check per record instead of one per field. Near the end
+ *    of the buffer, or with MPACK_WRITE_TRACKING (which must see every
+ *    element), it falls back to write_single_structure
+ */
+int write_single_structure_compiled(mpack_writer_t* writer, const wifi_softap_info_t* info) {
+    if (!writer || !info) return -1;
+
+#if !MPACK_WRITE_TRACKING
+    if (mpack_writer_error(writer) == mpack_ok && mpack_writer_buffer_left(writer) >= MPACK_RECORD_MAX_SIZE) {
+        writer->position = mpack_put_record(writer->position, info);
+        return 0;
+    }
+#endif
+
+    return write_single_structure(writer, info);
+}
+
+/* array header for a known count, same choice as mpack_start_array */
+static inline char* mpack_put_array_header(char* p, uint32_t count) {
+    if (count <= 15) {
+        *p = (char)(0x90 | count);
+        return p + 1;
+    } else if (count <= UINT16_MAX) {
+        p[0] = (char)0xdc;
+        mpack_store_u16(p + 1, (uint16_t)count);
+        return p + 3;
+    }
+    p[0] = (char)0xdd;
+    mpack_store_u32(p + 1, count);
+    return p + 5;
+}
+
+/*
+ * write_structure_array_presized
+ *  - writes a known-count array of records: the array header once, then the
+ *    records back to back. When the whole array fits (one check against
+ *    count * MPACK_RECORD_MAX_SIZE) nothing is checked or counted per record
+ *  - with MPACK_WRITE_TRACKING or MPACK_BUILDER the writer must see every
+ *    element, so it goes through mpack_start_array / mpack_finish_array
+ *  - return: 0 on success, -1 on failure
+ */
+int write_structure_array_presized(mpack_writer_t* writer, const wifi_softap_info_t* infos, int count) {
+    if (!writer) return -1;
+    if (!infos || count < 0) {
+        /* the callers only check the writer, so the error must be on it */
+        mpack_writer_flag_error(writer, mpack_error_bug);
+        return -1;
+    }
+
+#if !MPACK_WRITE_TRACKING && !MPACK_BUILDER
+    if (mpack_writer_error(writer) == mpack_ok &&
+        mpack_writer_buffer_left(writer) / MPACK_RECORD_MAX_SIZE > (size_t)count) {
+        char* p = mpack_put_array_header(writer->position, (uint32_t)count);
+        for (int i = 0; i < count; i++) {
+            p = mpack_put_record(p, &infos[i]);
+        }
+        writer->position = p;
+        return 0;
+    }
+#endif
+
+    mpack_start_array(writer, (uint32_t)count);
+    for (int i = 0; i < count; i++) {
+        if (write_single_structure_compiled(writer, &infos[i]) != 0) {
+            mpack_writer_flag_error(writer, mpack_error_data);
+            break;
+        }
+    }
+    mpack_finish_array(writer);
+    return mpack_writer_error(writer) == mpack_ok ? 0 : -1;
+}
+
 /* Helper function to read a single wifi_softap_info_t structure */
 int read_single_structure(mpack_reader_t* reader, wifi_softap_info_t* info) {
     if (!reader || !info) return -1;
 
     /* read an array of 9 elements (fixed-order schema) */
-    mpack_expect_array_match(reader, 9);
+    mpack_expect_array_match(reader, MPACK_FIELD_COUNT);
 
     info->device_count = mpack_expect_i32(reader);
     info->state = mpack_expect_i32(reader);
 
-    char buf[WIFI_SSID_MAX_LEN];
-    size_t binlen = mpack_expect_bin_buf(reader, buf, sizeof(buf));
-    if (binlen != sizeof(info->ip_address.ipv4)) {
-        return -1;
-    }
-    memcpy(info->ip_address.ipv4, buf, binlen);
-
-    binlen = mpack_expect_bin_buf(reader, buf, sizeof(buf));
-    if (binlen != sizeof(info->ip_address.ipv6)) {
-        return -1;
-    }
-    memcpy(info->ip_address.ipv6, buf, binlen);
+    /* bins are read straight into the destination fields. The fixed-size
+     * ones must match exactly, otherwise the reader flags an error */
+    mpack_expect_bin_size_buf(reader, (char*)info->ip_address.ipv4, sizeof(info->ip_address.ipv4));
+    mpack_expect_bin_size_buf(reader, (char*)info->ip_address.ipv6, sizeof(info->ip_address.ipv6));
 
-    binlen = mpack_expect_bin_buf(reader, buf, sizeof(buf));
-    if (binlen > WIFI_SSID_MAX_LEN) {
-        return -1;
-    }
-    if (binlen > 0) memcpy(info->ssid, buf, binlen);
+    /* ssid: at most WIFI_SSID_MAX_LEN bytes (too_big error otherwise) */
+    size_t binlen = mpack_expect_bin_buf(reader, info->ssid, WIFI_SSID_MAX_LEN);
     info->ssid[binlen] = '\0';
 
-    binlen = mpack_expect_bin_buf(reader, buf, sizeof(buf));
-    if (binlen != WIFI_BT_MAC_ADDRESS_LEN) {
-        return -1;
-    }
-    memcpy(info->bssid, buf, binlen);
+    mpack_expect_bin_size_buf(reader, (char*)info->bssid, WIFI_BT_MAC_ADDRESS_LEN);
 
     info->security = mpack_expect_i32(reader);
     info->channel = mpack_expect_u8(reader);
     info->frequency = mpack_expect_u16(reader);
 
     mpack_done_array(reader);
-    return 0;
+    return mpack_reader_error(reader) == mpack_ok ? 0 : -1;
+}
+
+/* ---------- single-bounds-check reader ---------- */
+/*
+ * Parses one record from p with no bounds checks; p must have at least
+ * MPACK_RECORD_MAX_SIZE readable bytes. Only the encodings our writers
+ * produce are handled (fixint/uint/int tags up to 32 bits, bin8); anything
+ * else returns NULL so the caller can use the checked reader, which also
+ * reports the proper error.
+ * returns: pointer past the record, or NULL
+ */
+#if !MPACK_READ_TRACKING
+static const char* mpack_parse_i32_unchecked(const char* p, int32_t* value) {
+    uint8_t tag = mpack_load_u8(p);
+    if (tag <= 0x7f || tag >= 0xe0) {
+        *value = (int8_t)tag;
+        return p + 1;
+    }
+    switch (tag) {
+        case 0xcc: *value = mpack_load_u8(p + 1); return p + 2;
+        case 0xcd: *value = mpack_load_u16(p + 1); return p + 3;
+        case 0xce:
+            if (mpack_load_u32(p + 1) > INT32_MAX) return NULL;
+            *value = (int32_t)mpack_load_u32(p + 1);
+            return p + 5;
+        case 0xd0: *value = mpack_load_i8(p + 1); return p + 2;
+        case 0xd1: *value = mpack_load_i16(p + 1); return p + 3;
+        case 0xd2: *value = mpack_load_i32(p + 1); return p + 5;
+        default: return NULL;
+    }
+}
+
+static const char* mpack_parse_record_unchecked(const char* p, wifi_softap_info_t* info) {
+    int32_t value;
+    uint8_t tag;
+
+    if (mpack_load_u8(p++) != (0x90 | MPACK_FIELD_COUNT)) return NULL;
+
+    if (!(p = mpack_parse_i32_unchecked(p, &value))) return NULL;
+    info->device_count = value;
+    if (!(p = mpack_parse_i32_unchecked(p, &value))) return NULL;
+    info->state = value;
+
+    /* fixed bins: bin8 tag and exact length in one 16-bit compare */
+    if (mpack_load_u16(p) != (0xc400 | IPV4_LEN)) return NULL;
+    memcpy(info->ip_address.ipv4, p + 2, IPV4_LEN);
+    p += 2 + IPV4_LEN;
+    if (mpack_load_u16(p) != (0xc400 | IPV6_LEN)) return NULL;
+    memcpy(info->ip_address.ipv6, p + 2, IPV6_LEN);
+    p += 2 + IPV6_LEN;
+
+    uint8_t sslen = mpack_load_u8(p + 1);
+    if (mpack_load_u8(p) != 0xc4 || sslen > WIFI_SSID_MAX_LEN) return NULL;
+    memcpy(info->ssid, p + 2, sslen);
+    info->ssid[sslen] = '\0';
+    p += 2 + sslen;
+
+    if (mpack_load_u16(p) != (0xc400 | WIFI_BT_MAC_ADDRESS_LEN)) return NULL;
+    memcpy(info->bssid, p + 2, WIFI_BT_MAC_ADDRESS_LEN);
+    p += 2 + WIFI_BT_MAC_ADDRESS_LEN;
+
+    if (!(p = mpack_parse_i32_unchecked(p, &value))) return NULL;
+    info->security = value;
+
+    tag = mpack_load_u8(p);
+    if (tag <= 0x7f) {
+        info->channel = tag;
+        p += 1;
+    } else if (tag == 0xcc) {
+        info->channel = mpack_load_u8(p + 1);
+        p += 2;
+    } else {
+        return NULL;
+    }
+
+    tag = mpack_load_u8(p);
+    if (tag <= 0x7f) {
+        info->frequency = tag;
+        p += 1;
+    } else if (tag == 0xcc) {
+        info->frequency = mpack_load_u8(p + 1);
+        p += 2;
+    } else if (tag == 0xcd) {
+        info->frequency = mpack_load_u16(p + 1);
+        p += 3;
+    } else {
+        return NULL;
+    }
+
+    return p;
+}
+#endif
+
+/*
+ * read_single_structure_fast
+ *  - checks once that MPACK_RECORD_MAX_SIZE bytes are left, then decodes the
+ *    whole record with unchecked reads. Near the end of the input the
+ *    remaining bytes are copied into a zero-padded local buffer first, and
+ *    the record must turn out to fit in what was really left
+ *  - on an unexpected tag or a short input it falls back to
+ *    read_single_structure. Also with MPACK_READ_TRACKING, which must see
+ *    every element
+ */
+int read_single_structure_fast(mpack_reader_t* reader, wifi_softap_info_t* info) {
+    if (!reader || !info) return -1;
+
+#if !MPACK_READ_TRACKING
+    if (mpack_reader_error(reader) == mpack_ok) {
+        const char* p = reader->data;
+        size_t left = (size_t)(reader->end - reader->data);
+        char padded[MPACK_RECORD_MAX_SIZE];
+        if (left < MPACK_RECORD_MAX_SIZE) {
+            memcpy(padded, p, left);
+            memset(padded + left, 0, sizeof(padded) - left);
+            p = padded;
+        }
+
+        const char* next = mpack_parse_record_unchecked(p, info);
+        if (next && (size_t)(next - p) <= left) {
+            reader->data += next - p;
+            return 0;
+        }
+    }
+#endif
+
+    return read_single_structure(reader, info);
 }
 
 /* ---------- mpack encode / decode ---------- */
@@ -113,7 +404,7 @@ int mpack_encode(wifi_softap_info_t* info, void* out_buffer, size_t* out_size) {
     mpack_writer_t writer;
     mpack_writer_init(&writer, (char*)out_buffer, MAX_BUFFER);
 
-    if (write_single_structure(&writer, info) != 0) {
+    if (write_single_structure_compiled(&writer, info) != 0) {
         mpack_writer_flag_error(&writer, mpack_error_data);
     }
 
@@ -140,7 +431,7 @@ int mpack_decode(void* buffer, size_t size, wifi_softap_info_t* out_info) {
     mpack_reader_t reader;
     mpack_reader_init_data(&reader, (const char*)buffer, size);
 
-    if (read_single_structure(&reader, out_info) != 0) {
+    if (read_single_structure_fast(&reader, out_info) != 0) {
         mpack_reader_flag_error(&reader, mpack_error_data);
     }
 
@@ -158,14 +449,7 @@ int mpack_encode_array(const wifi_softap_info_t* infos, int count, void* out_buf
     mpack_writer_t writer;
     mpack_writer_init(&writer, (char*)out_buffer, MAX_BUFFER);
 
-    mpack_start_array(&writer, (uint32_t)count);
-    for (int i = 0; i < count; i++) {
-        if (write_single_structure(&writer, &infos[i]) != 0) {
-            mpack_writer_flag_error(&writer, mpack_error_data);
-            break;
-        }
-    }
-    mpack_finish_array(&writer);
+    write_structure_array_presized(&writer, infos, count);
 
     *out_size = mpack_writer_buffer_used(&writer);
     mpack_error_t err = mpack_writer_destroy(&writer);
@@ -190,7 +474,7 @@ int mpack_decode_array(void* buffer, size_t size, wifi_softap_info_t* out_infos,
     }
 
     for (int i = 0; i < count; i++) {
-        if (read_single_structure(&reader, out_infos + i) != 0) {
+        if (read_single_structure_fast(&reader, out_infos + i) != 0) {
             mpack_reader_flag_error(&reader, mpack_error_data);
             break;
         }
@@ -206,4 +490,1127 @@ int mpack_decode_array(void* buffer, size_t size, wifi_softap_info_t* out_infos,
     return 0;
 }
 
+/* ---------- mpack node tree decode ---------- */
+/*
+ * One node per array and per field: the outer array plus MAX_ARRAY records
+ * of 1 + 9 nodes. The pool is reused by every parse, so the parsed tree is
+ * only valid until the next mpack_usage_tree_open() call.
+ */
+#define MPACK_NODE_POOL_COUNT (1 + MAX_ARRAY * (1 + MPACK_FIELD_COUNT))
+static mpack_node_data_t mpack_node_pool[MPACK_NODE_POOL_COUNT];
+
+/*
+ * mpack_usage_tree_open
+ *  - input: *buffer, size (must stay valid while the tree is used)
+ *  - output: tree parsed into the static node pool
+ *  - return: 0 on success, -1 on failure (tree still needs mpack_tree_destroy)
+ */
+int mpack_usage_tree_open(mpack_tree_t* tree, const void* buffer, size_t size) {
+    mpack_tree_init_pool(tree, (const char*)buffer, size, mpack_node_pool, MPACK_NODE_POOL_COUNT);
+    mpack_tree_parse(tree);
+    return mpack_tree_error(tree) == mpack_ok ? 0 : -1;
+}
+
+/* copy a bin node of exactly len bytes, in place from the message data */
+static int read_node_bin(mpack_node_t node, void* dst, size_t len) {
+    if (mpack_node_bin_size(node) != len) return -1;
+    memcpy(dst, mpack_node_bin_data(node), len);
+    return 0;
+}
+
+/* Helper function to read a single wifi_softap_info_t structure from a record node */
+int read_single_node(mpack_node_t node, wifi_softap_info_t* info) {
+    if (!info) return -1;
+    if (mpack_node_array_length(node) != MPACK_FIELD_COUNT) return -1;
+
+    info->device_count = mpack_node_i32(mpack_node_array_at(node, MPACK_FIELD_DEVICE_COUNT));
+    info->state = mpack_node_i32(mpack_node_array_at(node, MPACK_FIELD_STATE));
+
+    if (read_node_bin(mpack_node_array_at(node, MPACK_FIELD_IPV4), info->ip_address.ipv4, sizeof(info->ip_address.ipv4)) != 0 ||
+        read_node_bin(mpack_node_array_at(node, MPACK_FIELD_IPV6), info->ip_address.ipv6, sizeof(info->ip_address.ipv6)) != 0 ||
+        read_node_bin(mpack_node_array_at(node, MPACK_FIELD_BSSID), info->bssid, WIFI_BT_MAC_ADDRESS_LEN) != 0) {
+        return -1;
+    }
+
+    mpack_node_t ssid = mpack_node_array_at(node, MPACK_FIELD_SSID);
+    size_t sslen = mpack_node_bin_size(ssid);
+    if (sslen > WIFI_SSID_MAX_LEN) return -1;
+    if (sslen > 0) memcpy(info->ssid, mpack_node_bin_data(ssid), sslen);
+    info->ssid[sslen] = '\0';
+
+    info->security = mpack_node_i32(mpack_node_array_at(node, MPACK_FIELD_SECURITY));
+    info->channel = mpack_node_u8(mpack_node_array_at(node, MPACK_FIELD_CHANNEL));
+    info->frequency = mpack_node_u16(mpack_node_array_at(node, MPACK_FIELD_FREQUENCY));
+
+    return mpack_node_error(node) == mpack_ok ? 0 : -1;
+}
+
+/*
+ * mpack_decode_node
+ *  - input: *buffer, size
+ *  - output: wifi_softap_info_t *info
+ *  - return: 0 on success, -1 on failure
+ */
+int mpack_decode_node(void* buffer, size_t size, wifi_softap_info_t* out_info) {
+    if (!buffer || size == 0 || !out_info) return -1;
+
+    mpack_tree_t tree;
+    if (mpack_usage_tree_open(&tree, buffer, size) == 0) {
+        if (read_single_node(mpack_tree_root(&tree), out_info) != 0) {
+            mpack_tree_flag_error(&tree, mpack_error_data);
+        }
+    }
+
+    mpack_error_t err = mpack_tree_destroy(&tree);
+    if (err != mpack_ok) {
+        fprintf(stderr, "mpack: tree error %d\n", err);
+        return -1;
+    }
+    return 0;
+}
+
+int mpack_decode_array_node(void* buffer, size_t size, wifi_softap_info_t* out_infos, int* out_count) {
+    if (!buffer || size == 0 || !out_infos || !out_count) return -1;
+
+    mpack_tree_t tree;
+    size_t count = 0;
+    if (mpack_usage_tree_open(&tree, buffer, size) == 0) {
+        mpack_node_t root = mpack_tree_root(&tree);
+        count = mpack_node_array_length(root);
+        if (count > MAX_ARRAY) mpack_tree_flag_error(&tree, mpack_error_too_big);
+
+        for (size_t i = 0; i < count && mpack_tree_error(&tree) == mpack_ok; i++) {
+            if (read_single_node(mpack_node_array_at(root, i), out_infos + i) != 0) {
+                mpack_tree_flag_error(&tree, mpack_error_data);
+            }
+        }
+    }
+
+    mpack_error_t err = mpack_tree_destroy(&tree);
+    if (err != mpack_ok) {
+        return -1;
+    }
+
+    *out_count = (int)count;
+    return 0;
+}
+
+/*
+ * mpack_node_record_at
+ *  - random access into an array parsed by mpack_usage_tree_open():
+ *    returns the record node at index, whose fields are read with
+ *    mpack_node_array_at(record, MPACK_FIELD_*), without decoding the
+ *    other records
+ *  - out of range flags an error on the tree and returns a nil node
+ */
+mpack_node_t mpack_node_record_at(mpack_tree_t* tree, size_t index) {
+    return mpack_node_array_at(mpack_tree_root(tree), index);
+}
+
+/* ---------- keyed-map schema ---------- */
+/*
+ * Schema: map of short string keys to the same values as the array schema
+ *     { "count": int32, "state": int32, "ipv4": bin 4, "ipv6": bin 16,
+ *       "ssid": bin N, "bssid": bin 6, "security": int32,
+ *       "channel": uint8, "freq": uint16 }
+ * Keys may come in any order, missing keys leave the field zeroed and
+ * unknown keys are skipped, so peers can add or reorder fields.
+ */
+static const char* const mpack_map_keys[MPACK_FIELD_COUNT] = {
+    [MPACK_FIELD_DEVICE_COUNT] = "count",
+    [MPACK_FIELD_STATE] = "state",
+    [MPACK_FIELD_IPV4] = "ipv4",
+    [MPACK_FIELD_IPV6] = "ipv6",
+    [MPACK_FIELD_SSID] = "ssid",
+    [MPACK_FIELD_BSSID] = "bssid",
+    [MPACK_FIELD_SECURITY] = "security",
+    [MPACK_FIELD_CHANNEL] = "channel",
+    [MPACK_FIELD_FREQUENCY] = "freq",
+};
+
+/*
+ * returns the MPACK_FIELD_* of a key, or -1 for an unknown key. The length
+ * and the first byte (the last one for ipv4 / ipv6) pick the only candidate,
+ * which is then compared once, in place.
+ */
+#define MPACK_MAP_MATCH(key, field, len) (memcmp((key), mpack_map_keys[(field)], (len)) == 0 ? (field) : -1)
+static int mpack_map_field(const char* key, size_t len) {
+    /* constant lengths, so each compare is inlined rather than a memcmp call */
+    switch (len) {
+        case 4:
+            switch (key[0]) {
+                case 'i': return MPACK_MAP_MATCH(key, key[3] == '4' ? MPACK_FIELD_IPV4 : MPACK_FIELD_IPV6, 4);
+                case 's': return MPACK_MAP_MATCH(key, MPACK_FIELD_SSID, 4);
+                case 'f': return MPACK_MAP_MATCH(key, MPACK_FIELD_FREQUENCY, 4);
+                default: return -1;
+            }
+        case 5:
+            switch (key[0]) {
+                case 'c': return MPACK_MAP_MATCH(key, MPACK_FIELD_DEVICE_COUNT, 5);
+                case 's': return MPACK_MAP_MATCH(key, MPACK_FIELD_STATE, 5);
+                case 'b': return MPACK_MAP_MATCH(key, MPACK_FIELD_BSSID, 5);
+                default: return -1;
+            }
+        case 7: return MPACK_MAP_MATCH(key, MPACK_FIELD_CHANNEL, 7);
+        case 8: return MPACK_MAP_MATCH(key, MPACK_FIELD_SECURITY, 8);
+        default: return -1;
+    }
+}
+
+/*
+ * Reads one map key and returns its MPACK_FIELD_*, -1 for an unknown key.
+ * Keys our writers produce are fixstr: the tag gives the length and the key
+ * is matched where it lies, the reader just moves past it. Anything else
+ * (str8, or MPACK_READ_TRACKING, which must see every element) goes through
+ * mpack_expect_str.
+ */
+static int mpack_expect_map_field(mpack_reader_t* reader) {
+#if !MPACK_READ_TRACKING
+    if (mpack_reader_error(reader) == mpack_ok && reader->data < reader->end) {
+        uint8_t tag = mpack_load_u8(reader->data);
+        size_t len = tag & 0x1f;
+        if ((tag & 0xe0) == 0xa0 && len < (size_t)(reader->end - reader->data)) {
+            const char* key = reader->data + 1;
+            reader->data += 1 + len;
+            return mpack_map_field(key, len);
+        }
+    }
+#endif
+
+    uint32_t keylen = mpack_expect_str(reader);
+    const char* key = keylen > 0 ? mpack_read_bytes_inplace(reader, keylen) : NULL;
+    mpack_done_str(reader);
+    if (mpack_reader_error(reader) != mpack_ok) return -1;
+    return mpack_map_field(key, keylen);
+}
+
+/* Helper function to write a single wifi_softap_info_t structure as a keyed map */
+int write_single_structure_map(mpack_writer_t* writer, const wifi_softap_info_t* info) {
+    if (!writer || !info) return -1;
+
+    mpack_start_map(writer, MPACK_FIELD_COUNT);
+
+    mpack_write_cstr(writer, mpack_map_keys[MPACK_FIELD_DEVICE_COUNT]);
+    mpack_write_i32(writer, (int32_t)info->device_count);
+    mpack_write_cstr(writer, mpack_map_keys[MPACK_FIELD_STATE]);
+    mpack_write_i32(writer, (int32_t)info->state);
+    mpack_write_cstr(writer, mpack_map_keys[MPACK_FIELD_IPV4]);
+    mpack_write_bin(writer, (const char*)info->ip_address.ipv4, sizeof(info->ip_address.ipv4));
+    mpack_write_cstr(writer, mpack_map_keys[MPACK_FIELD_IPV6]);
+    mpack_write_bin(writer, (const char*)info->ip_address.ipv6, sizeof(info->ip_address.ipv6));
+    mpack_write_cstr(writer, mpack_map_keys[MPACK_FIELD_SSID]);
+    mpack_write_bin(writer, info->ssid, (uint32_t)strnlen(info->ssid, WIFI_SSID_MAX_LEN));
+    mpack_write_cstr(writer, mpack_map_keys[MPACK_FIELD_BSSID]);
+    mpack_write_bin(writer, (const char*)info->bssid, WIFI_BT_MAC_ADDRESS_LEN);
+    mpack_write_cstr(writer, mpack_map_keys[MPACK_FIELD_SECURITY]);
+    mpack_write_i32(writer, (int32_t)info->security);
+    mpack_write_cstr(writer, mpack_map_keys[MPACK_FIELD_CHANNEL]);
+    mpack_write_u8(writer, info->channel);
+    mpack_write_cstr(writer, mpack_map_keys[MPACK_FIELD_FREQUENCY]);
+    mpack_write_u16(writer, info->frequency);
+
+    mpack_finish_map(writer);
+    return 0;
+}
+
+/* field handler: reads the value of one known key */
+static void read_map_field(mpack_reader_t* reader, int field, wifi_softap_info_t* info) {
+    size_t sslen;
+
+    switch (field) {
+        case MPACK_FIELD_DEVICE_COUNT:
+            info->device_count = mpack_expect_i32(reader);
+            break;
+        case MPACK_FIELD_STATE:
+            info->state = mpack_expect_i32(reader);
+            break;
+        case MPACK_FIELD_IPV4:
+            mpack_expect_bin_size_buf(reader, (char*)info->ip_address.ipv4, sizeof(info->ip_address.ipv4));
+            break;
+        case MPACK_FIELD_IPV6:
+            mpack_expect_bin_size_buf(reader, (char*)info->ip_address.ipv6, sizeof(info->ip_address.ipv6));
+            break;
+        case MPACK_FIELD_SSID:
+            sslen = mpack_expect_bin_buf(reader, info->ssid, WIFI_SSID_MAX_LEN);
+            info->ssid[sslen] = '\0';
+            break;
+        case MPACK_FIELD_BSSID:
+            mpack_expect_bin_size_buf(reader, (char*)info->bssid, WIFI_BT_MAC_ADDRESS_LEN);
+            break;
+        case MPACK_FIELD_SECURITY:
+            info->security = mpack_expect_i32(reader);
+            break;
+        case MPACK_FIELD_CHANNEL:
+            info->channel = mpack_expect_u8(reader);
+            break;
+        case MPACK_FIELD_FREQUENCY:
+            info->frequency = mpack_expect_u16(reader);
+            break;
+        default:
+            mpack_discard(reader);
+            break;
+    }
+}
+
+#if !MPACK_READ_TRACKING
+/* the largest value of a known key: the ssid bin8 */
+#define MPACK_MAP_VALUE_MAX_SIZE (2 + WIFI_SSID_MAX_LEN)
+
+/*
+ * read_map_field, unchecked: p must have MPACK_MAP_VALUE_MAX_SIZE readable
+ * bytes. Same encodings as mpack_parse_record_unchecked, NULL for anything
+ * else (and for unknown keys) so the caller can use read_map_field.
+ * returns: pointer past the value, or NULL
+ */
+static const char* mpack_parse_map_field_unchecked(const char* p, int field, wifi_softap_info_t* info) {
+    int32_t value;
+    uint8_t tag, len;
+
+    switch (field) {
+        case MPACK_FIELD_DEVICE_COUNT:
+        case MPACK_FIELD_STATE:
+        case MPACK_FIELD_SECURITY:
+            if (!(p = mpack_parse_i32_unchecked(p, &value))) return NULL;
+            if (field == MPACK_FIELD_DEVICE_COUNT) info->device_count = value;
+            else if (field == MPACK_FIELD_STATE) info->state = value;
+            else info->security = value;
+            return p;
+        case MPACK_FIELD_IPV4:
+            if (mpack_load_u16(p) != (0xc400 | IPV4_LEN)) return NULL;
+            memcpy(info->ip_address.ipv4, p + 2, IPV4_LEN);
+            return p + 2 + IPV4_LEN;
+        case MPACK_FIELD_IPV6:
+            if (mpack_load_u16(p) != (0xc400 | IPV6_LEN)) return NULL;
+            memcpy(info->ip_address.ipv6, p + 2, IPV6_LEN);
+            return p + 2 + IPV6_LEN;
+        case MPACK_FIELD_SSID:
+            len = mpack_load_u8(p + 1);
+            if (mpack_load_u8(p) != 0xc4 || len > WIFI_SSID_MAX_LEN) return NULL;
+            /* fixed-size copy, p has MPACK_MAP_VALUE_MAX_SIZE bytes */
+            memcpy(info->ssid, p + 2, WIFI_SSID_MAX_LEN);
+            info->ssid[len] = '\0';
+            return p + 2 + len;
+        case MPACK_FIELD_BSSID:
+            if (mpack_load_u16(p) != (0xc400 | WIFI_BT_MAC_ADDRESS_LEN)) return NULL;
+            memcpy(info->bssid, p + 2, WIFI_BT_MAC_ADDRESS_LEN);
+            return p + 2 + WIFI_BT_MAC_ADDRESS_LEN;
+        case MPACK_FIELD_CHANNEL:
+            tag = mpack_load_u8(p);
+            if (tag <= 0x7f) {
+                info->channel = tag;
+                return p + 1;
+            }
+            if (tag != 0xcc) return NULL;
+            info->channel = mpack_load_u8(p + 1);
+            return p + 2;
+        case MPACK_FIELD_FREQUENCY:
+            tag = mpack_load_u8(p);
+            if (tag <= 0x7f) {
+                info->frequency = tag;
+                return p + 1;
+            }
+            if (tag == 0xcc) {
+                info->frequency = mpack_load_u8(p + 1);
+                return p + 2;
+            }
+            if (tag != 0xcd) return NULL;
+            info->frequency = mpack_load_u16(p + 1);
+            return p + 3;
+        default:
+            return NULL;
+    }
+}
+#endif
+
+/* Helper function to read a single wifi_softap_info_t structure from a keyed map */
+int read_single_structure_map(mpack_reader_t* reader, wifi_softap_info_t* info) {
+    if (!reader || !info) return -1;
+
+    memset(info, 0, sizeof(*info));
+    uint32_t count = mpack_expect_map(reader);
+
+    for (uint32_t i = 0; i < count && mpack_reader_error(reader) == mpack_ok; i++) {
+        int field = mpack_expect_map_field(reader);
+        if (mpack_reader_error(reader) != mpack_ok) break;
+
+#if !MPACK_READ_TRACKING
+        /* one bounds check for the whole value, then unchecked reads */
+        if ((size_t)(reader->end - reader->data) >= MPACK_MAP_VALUE_MAX_SIZE) {
+            const char* next = mpack_parse_map_field_unchecked(reader->data, field, info);
+            if (next) {
+                reader->data = next;
+                continue;
+            }
+        }
+#endif
+        /* unknown keys go to the default handler, which skips the value */
+        read_map_field(reader, field, info);
+    }
+
+    mpack_done_map(reader);
+    return mpack_reader_error(reader) == mpack_ok ? 0 : -1;
+}
+
+/*
+ * mpack_encode_map
+ *  - input: wifi_softap_info_t *info
+ *  - output: *out_buffer, *out_size
+ *  - return: 0 on success, -1 on failure
+ */
+int mpack_encode_map(wifi_softap_info_t* info, void* out_buffer, size_t* out_size) {
+    if (!info || !out_buffer || !out_size) return -1;
+
+    mpack_writer_t writer;
+    mpack_writer_init(&writer, (char*)out_buffer, MAX_BUFFER);
+
+    if (write_single_structure_map(&writer, info) != 0) {
+        mpack_writer_flag_error(&writer, mpack_error_data);
+    }
+
+    *out_size = mpack_writer_buffer_used(&writer);
+    mpack_error_t err = mpack_writer_destroy(&writer);
+    if (err != mpack_ok) {
+        fprintf(stderr, "mpack: writer error %d\n", err);
+        return -1;
+    }
+
+    return 0;
+}
+
+/*
+ * mpack_decode_map
+ *  - input: *buffer, size
+ *  - output: wifi_softap_info_t *info
+ *  - return: 0 on success, -1 on failure
+ */
+int mpack_decode_map(void* buffer, size_t size, wifi_softap_info_t* out_info) {
+    if (!buffer || size == 0 || !out_info) return -1;
+
+    mpack_reader_t reader;
+    mpack_reader_init_data(&reader, (const char*)buffer, size);
+
+    if (read_single_structure_map(&reader, out_info) != 0) {
+        mpack_reader_flag_error(&reader, mpack_error_data);
+    }
+
+    mpack_error_t err = mpack_reader_destroy(&reader);
+    if (err != mpack_ok) {
+        fprintf(stderr, "mpack: reader error %d\n", err);
+        return -1;
+    }
+    return 0;
+}
+
+int mpack_encode_array_map(const wifi_softap_info_t* infos, int count, void* out_buffer, size_t* out_size) {
+    if (!infos || count == 0 || !out_buffer || !out_size) return -1;
+
+    mpack_writer_t writer;
+    mpack_writer_init(&writer, (char*)out_buffer, MAX_BUFFER);
+
+    mpack_start_array(&writer, (uint32_t)count);
+    for (int i = 0; i < count; i++) {
+        if (write_single_structure_map(&writer, &infos[i]) != 0) {
+            mpack_writer_flag_error(&writer, mpack_error_data);
+            break;
+        }
+    }
+    mpack_finish_array(&writer);
+
+    *out_size = mpack_writer_buffer_used(&writer);
+    mpack_error_t err = mpack_writer_destroy(&writer);
+    if (err != mpack_ok) {
+        fprintf(stderr, "mpack: writer error %d\n", err);
+        return -1;
+    }
+
+    return 0;
+}
+
+int mpack_decode_array_map(void* buffer, size_t size, wifi_softap_info_t* out_infos, int* out_count) {
+    if (!buffer || size == 0 || !out_infos || !out_count) return -1;
+
+    mpack_reader_t reader;
+    mpack_reader_init_data(&reader, (const char*)buffer, size);
+
+    int count = mpack_expect_array_max(&reader, MAX_ARRAY);
+    if (mpack_reader_error(&reader) != mpack_ok) {
+        mpack_reader_destroy(&reader);
+        return -1;
+    }
+
+    for (int i = 0; i < count; i++) {
+        if (read_single_structure_map(&reader, out_infos + i) != 0) {
+            mpack_reader_flag_error(&reader, mpack_error_data);
+            break;
+        }
+    }
+    mpack_done_array(&reader);
+
+    mpack_error_t err = mpack_reader_destroy(&reader);
+    if (err != mpack_ok) {
+        return -1;
+    }
+
+    *out_count = count;
+    return 0;
+}
+
+/* ---------- per-batch dictionary array ---------- */
+/*
+ * Schema: array of 4 elements
+ *     [ flags (uint, MPACK_DICT_FLAG_DICT),
+ *       ssids (array of bin N, one per distinct ssid),
+ *       ouis (bin 3 * M, the M distinct BSSID vendor prefixes),
+ *       records (array of count records) ]
+ * and a record is an array of 10 elements: the 9-element schema with ssid
+ * and bssid replaced by references into the dictionaries
+ *     [ device_count (int32), state (int32), ipv4 (bin 4), ipv6 (bin 16),
+ *       ssid index (uint), OUI index (uint), bssid[3..5] (bin 3),
+ *       security (int32), channel (uint8), frequency (uint16) ]
+ * When the dictionaries would not make the batch smaller (no repeats, or a
+ * single record) the encoder writes [ flags (0), records ] instead, records
+ * in the 9-element schema.
+ * The dictionaries are built per call (DICT/dict_usage.h), entries in order
+ * of first appearance. The decoder copies each ssid entry once into a
+ * terminated slot, so resolving a record is a fixed-size copy (the bytes
+ * after the terminator are not meaningful).
+ */
+#define MPACK_DICT_FIELD_COUNT (MPACK_FIELD_COUNT + 1)
+#define MPACK_DICT_FLAG_DICT 0x01
+
+/* array tag, 3 i32, 2 index u16, ipv4 / ipv6 / nic bin8, channel u8, frequency u16 */
+#define MPACK_DICT_RECORD_MAX_SIZE (1 + 3 * 5 + 2 * 3 + 3 * 2 + IPV4_LEN + IPV6_LEN + DICT_NIC_LEN + 2 + 3)
+
+typedef struct {
+    int ssid_count;
+    int oui_count;
+    char ssid[DICT_MAX_RECORDS][WIFI_SSID_MAX_LEN + 1]; /* terminated */
+    const char* ouis; /* oui_count * DICT_OUI_LEN, inside the received buffer */
+} mpack_dict_view_t;
+
+static dict_batch_t mpack_dict_batch;
+static mpack_dict_view_t mpack_dict_view;
+
+/* Helper function to write a single record referring to the dictionaries */
+int write_single_structure_dict(mpack_writer_t* writer, const wifi_softap_info_t* info, uint16_t ssid_index, uint16_t oui_index) {
+    if (!writer || !info) return -1;
+
+    mpack_start_array(writer, MPACK_DICT_FIELD_COUNT);
+
+    mpack_write_i32(writer, (int32_t)info->device_count);
+    mpack_write_i32(writer, (int32_t)info->state);
+    mpack_write_bin(writer, (const char*)info->ip_address.ipv4, sizeof(info->ip_address.ipv4));
+    mpack_write_bin(writer, (const char*)info->ip_address.ipv6, sizeof(info->ip_address.ipv6));
+    mpack_write_u16(writer, ssid_index);
+    mpack_write_u16(writer, oui_index);
+    mpack_write_bin(writer, (const char*)dict_nic(info->bssid), DICT_NIC_LEN);
+    mpack_write_i32(writer, (int32_t)info->security);
+    mpack_write_u8(writer, info->channel);
+    mpack_write_u16(writer, info->frequency);
+
+    mpack_finish_array(writer);
+    return 0;
+}
+
+/* one dictionary record, at most MPACK_DICT_RECORD_MAX_SIZE bytes, no checks */
+static inline char* mpack_put_record_dict(char* p, const wifi_softap_info_t* info, uint16_t ssid_index, uint16_t oui_index) {
+    *p++ = (char)(0x90 | MPACK_DICT_FIELD_COUNT);
+    p = mpack_put_i32(p, (int32_t)info->device_count);
+    p = mpack_put_i32(p, (int32_t)info->state);
+    p = mpack_put_bin8(p, info->ip_address.ipv4, IPV4_LEN);
+    p = mpack_put_bin8(p, info->ip_address.ipv6, IPV6_LEN);
+    p = mpack_put_u32(p, ssid_index);
+    p = mpack_put_u32(p, oui_index);
+    p = mpack_put_bin8(p, dict_nic(info->bssid), DICT_NIC_LEN);
+    p = mpack_put_i32(p, (int32_t)info->security);
+    p = mpack_put_u32(p, info->channel);
+    p = mpack_put_u32(p, info->frequency);
+    return p;
+}
+
+/* write_structure_array_presized for the records of a dictionary array */
+int write_structure_array_dict(mpack_writer_t* writer, const wifi_softap_info_t* infos, const dict_batch_t* dict) {
+    if (!writer) return -1;
+    if (!infos || !dict) {
+        mpack_writer_flag_error(writer, mpack_error_bug);
+        return -1;
+    }
+
+#if !MPACK_WRITE_TRACKING && !MPACK_BUILDER
+    if (mpack_writer_error(writer) == mpack_ok &&
+        mpack_writer_buffer_left(writer) / MPACK_DICT_RECORD_MAX_SIZE > (size_t)dict->count) {
+        char* p = mpack_put_array_header(writer->position, (uint32_t)dict->count);
+        for (int i = 0; i < dict->count; i++) {
+            p = mpack_put_record_dict(p, &infos[i], dict->ssid_ref[i], dict->oui_ref[i]);
+        }
+        writer->position = p;
+        return 0;
+    }
+#endif
+
+    mpack_start_array(writer, (uint32_t)dict->count);
+    for (int i = 0; i < dict->count; i++) {
+        write_single_structure_dict(writer, &infos[i], dict->ssid_ref[i], dict->oui_ref[i]);
+    }
+    mpack_finish_array(writer);
+    return 0;
+}
+
+/* ssid and bssid of a record from its dictionary references, -1 if out of range */
+static inline int mpack_dict_resolve(const mpack_dict_view_t* view, uint32_t ssid_index, uint32_t oui_index,
+                                     wifi_softap_info_t* info) {
+    if (ssid_index >= (uint32_t)view->ssid_count || oui_index >= (uint32_t)view->oui_count) return -1;
+
+    memcpy(info->ssid, view->ssid[ssid_index], sizeof(info->ssid));
+    memcpy(info->bssid, view->ouis + DICT_OUI_LEN * oui_index, DICT_OUI_LEN);
+    return 0;
+}
+
+/* Helper function to read a single record referring to the dictionaries */
+int read_single_structure_dict(mpack_reader_t* reader, const mpack_dict_view_t* view, wifi_softap_info_t* info) {
+    if (!reader || !view || !info) return -1;
+
+    mpack_expect_array_match(reader, MPACK_DICT_FIELD_COUNT);
+
+    info->device_count = mpack_expect_i32(reader);
+    info->state = mpack_expect_i32(reader);
+    mpack_expect_bin_size_buf(reader, (char*)info->ip_address.ipv4, sizeof(info->ip_address.ipv4));
+    mpack_expect_bin_size_buf(reader, (char*)info->ip_address.ipv6, sizeof(info->ip_address.ipv6));
+    uint32_t ssid_index = mpack_expect_u16(reader);
+    uint32_t oui_index = mpack_expect_u16(reader);
+    mpack_expect_bin_size_buf(reader, (char*)info->bssid + DICT_OUI_LEN, DICT_NIC_LEN);
+    info->security = mpack_expect_i32(reader);
+    info->channel = mpack_expect_u8(reader);
+    info->frequency = mpack_expect_u16(reader);
+
+    mpack_done_array(reader);
+    if (mpack_reader_error(reader) != mpack_ok) return -1;
+    return mpack_dict_resolve(view, ssid_index, oui_index, info);
+}
+
+#if !MPACK_READ_TRACKING
+/* positive fixint, uint8 or uint16 */
+static const char* mpack_parse_u16_unchecked(const char* p, uint32_t* value) {
+    uint8_t tag = mpack_load_u8(p);
+    if (tag <= 0x7f) {
+        *value = tag;
+        return p + 1;
+    }
+    switch (tag) {
+        case 0xcc: *value = mpack_load_u8(p + 1); return p + 2;
+        case 0xcd: *value = mpack_load_u16(p + 1); return p + 3;
+        default: return NULL;
+    }
+}
+
+/* same contract as mpack_parse_record_unchecked, with MPACK_DICT_RECORD_MAX_SIZE */
+static const char* mpack_parse_record_dict_unchecked(const char* p, const mpack_dict_view_t* view, wifi_softap_info_t* info) {
+    int32_t value;
+    uint32_t ssid_index, oui_index, number;
+
+    if (mpack_load_u8(p++) != (0x90 | MPACK_DICT_FIELD_COUNT)) return NULL;
+
+    if (!(p = mpack_parse_i32_unchecked(p, &value))) return NULL;
+    info->device_count = value;
+    if (!(p = mpack_parse_i32_unchecked(p, &value))) return NULL;
+    info->state = value;
+
+    if (mpack_load_u16(p) != (0xc400 | IPV4_LEN)) return NULL;
+    memcpy(info->ip_address.ipv4, p + 2, IPV4_LEN);
+    p += 2 + IPV4_LEN;
+    if (mpack_load_u16(p) != (0xc400 | IPV6_LEN)) return NULL;
+    memcpy(info->ip_address.ipv6, p + 2, IPV6_LEN);
+    p += 2 + IPV6_LEN;
+
+    if (!(p = mpack_parse_u16_unchecked(p, &ssid_index))) return NULL;
+    if (!(p = mpack_parse_u16_unchecked(p, &oui_index))) return NULL;
+    if (mpack_load_u16(p) != (0xc400 | DICT_NIC_LEN)) return NULL;
+    memcpy(info->bssid + DICT_OUI_LEN, p + 2, DICT_NIC_LEN);
+    p += 2 + DICT_NIC_LEN;
+
+    if (!(p = mpack_parse_i32_unchecked(p, &value))) return NULL;
+    info->security = value;
+    if (!(p = mpack_parse_u16_unchecked(p, &number)) || number > UINT8_MAX) return NULL;
+    info->channel = (uint8_t)number;
+    if (!(p = mpack_parse_u16_unchecked(p, &number))) return NULL;
+    info->frequency = (uint16_t)number;
+
+    if (mpack_dict_resolve(view, ssid_index, oui_index, info) != 0) return NULL;
+    return p;
+}
+#endif
+
+/* read_single_structure_fast for a dictionary record */
+int read_single_structure_dict_fast(mpack_reader_t* reader, const mpack_dict_view_t* view, wifi_softap_info_t* info) {
+    if (!reader || !view || !info) return -1;
+
+#if !MPACK_READ_TRACKING
+    if (mpack_reader_error(reader) == mpack_ok) {
+        const char* p = reader->data;
+        size_t left = (size_t)(reader->end - reader->data);
+        char padded[MPACK_DICT_RECORD_MAX_SIZE];
+        if (left < MPACK_DICT_RECORD_MAX_SIZE) {
+            memcpy(padded, p, left);
+            memset(padded + left, 0, sizeof(padded) - left);
+            p = padded;
+        }
+
+        const char* next = mpack_parse_record_dict_unchecked(p, view, info);
+        if (next && (size_t)(next - p) <= left) {
+            reader->data += next - p;
+            return 0;
+        }
+    }
+#endif
+
+    return read_single_structure_dict(reader, view, info);
+}
+
+/* bytes of a uint as the writers encode it */
+static inline size_t mpack_uint_size(uint32_t value) {
+    return value <= 0x7f ? 1 : value <= UINT8_MAX ? 2 : value <= UINT16_MAX ? 3 : 5;
+}
+
+/* bytes the dictionaries save over plain records, <= 0 if they do not pay off */
+static long mpack_dict_saving(const dict_batch_t* dict) {
+    long saving = 0;
+    for (int i = 0; i < dict->count; i++) {
+        /* ssid and bssid bins, against two indexes and the bssid[3..5] bin */
+        saving += 2 + dict->ssid_len[i] + 2 + WIFI_BT_MAC_ADDRESS_LEN;
+        saving -= (long)(mpack_uint_size(dict->ssid_ref[i]) + mpack_uint_size(dict->oui_ref[i]) + 2 + DICT_NIC_LEN);
+    }
+    saving -= dict->ssid_count <= 15 ? 1 : 3;
+    for (int e = 0; e < dict->ssid_count; e++) saving -= 2 + dict->ssid_len[dict->ssid_first[e]];
+    long oui_size = DICT_OUI_LEN * (long)dict->oui_count;
+    saving -= (oui_size <= UINT8_MAX ? 2 : 3) + oui_size;
+    return saving;
+}
+
+/*
+ * mpack_encode_array_dict
+ *  - input: wifi_softap_info_t *infos, int count
+ *  - output: *out_buffer, *out_size, dictionary array schema, without the
+ *    dictionaries if they would not make the batch smaller
+ *  - return: 0 on success, -1 on failure
+ */
+int mpack_encode_array_dict(const wifi_softap_info_t* infos, int count, void* out_buffer, size_t* out_size) {
+    if (!infos || count <= 0 || !out_buffer || !out_size) return -1;
+
+    dict_batch_t* dict = &mpack_dict_batch;
+    if (dict_build(dict, infos, count) != 0) return -1;
+
+    mpack_writer_t writer;
+    mpack_writer_init(&writer, (char*)out_buffer, MAX_BUFFER);
+
+    if (mpack_dict_saving(dict) <= 0) {
+        mpack_start_array(&writer, 2);
+        mpack_write_u8(&writer, 0);
+        write_structure_array_presized(&writer, infos, count);
+        mpack_finish_array(&writer);
+    } else {
+        mpack_start_array(&writer, 4);
+        mpack_write_u8(&writer, MPACK_DICT_FLAG_DICT);
+
+        mpack_start_array(&writer, (uint32_t)dict->ssid_count);
+        for (int e = 0; e < dict->ssid_count; e++) {
+            int first = dict->ssid_first[e];
+            mpack_write_bin(&writer, infos[first].ssid, dict->ssid_len[first]);
+        }
+        mpack_finish_array(&writer);
+
+        mpack_start_bin(&writer, (uint32_t)(dict->oui_count * DICT_OUI_LEN));
+        for (int e = 0; e < dict->oui_count; e++) {
+            mpack_write_bytes(&writer, (const char*)infos[dict->oui_first[e]].bssid, DICT_OUI_LEN);
+        }
+        mpack_finish_bin(&writer);
+
+        write_structure_array_dict(&writer, infos, dict);
+
+        mpack_finish_array(&writer);
+    }
+
+    *out_size = mpack_writer_buffer_used(&writer);
+    mpack_error_t err = mpack_writer_destroy(&writer);
+    if (err != mpack_ok) {
+        fprintf(stderr, "mpack: writer error %d\n", err);
+        return -1;
+    }
+
+    return 0;
+}
+
+/* the ssids and ouis elements of a dictionary array into view */
+static void mpack_read_dict_view(mpack_reader_t* reader, mpack_dict_view_t* view) {
+#if !MPACK_READ_TRACKING
+    /* a fixarray of ssids, the common case, without the reader */
+    if (mpack_reader_error(reader) == mpack_ok && reader->end - reader->data >= 1 &&
+        (mpack_load_u8(reader->data) & 0xf0) == 0x90) {
+        view->ssid_count = mpack_load_u8(reader->data) & 0x0f;
+        reader->data++;
+    } else
+#endif
+        view->ssid_count = (int)mpack_expect_array_max(reader, DICT_MAX_RECORDS);
+    for (int e = 0; e < view->ssid_count && mpack_reader_error(reader) == mpack_ok; e++) {
+        size_t len;
+#if !MPACK_READ_TRACKING
+        /* a bin8 with WIFI_SSID_MAX_LEN bytes readable after its header is
+         * copied without the reader, as one fixed-size copy */
+        const char* p = reader->data;
+        if (reader->end - p >= 2 + WIFI_SSID_MAX_LEN && mpack_load_u8(p) == 0xc4 &&
+            mpack_load_u8(p + 1) <= WIFI_SSID_MAX_LEN) {
+            len = mpack_load_u8(p + 1);
+            memcpy(view->ssid[e], p + 2, WIFI_SSID_MAX_LEN);
+            reader->data = p + 2 + len;
+        } else
+#endif
+            len = mpack_expect_bin_buf(reader, view->ssid[e], WIFI_SSID_MAX_LEN);
+        view->ssid[e][len] = '\0';
+    }
+    mpack_done_array(reader);
+
+    uint32_t oui_size;
+#if !MPACK_READ_TRACKING
+    /* a bin8 that is all in the buffer, kept in place without the reader */
+    const char* p = reader->data;
+    if (mpack_reader_error(reader) == mpack_ok && reader->end - p >= 2 && mpack_load_u8(p) == 0xc4 &&
+        reader->end - p - 2 >= mpack_load_u8(p + 1)) {
+        oui_size = mpack_load_u8(p + 1);
+        view->ouis = p + 2;
+        reader->data = p + 2 + oui_size;
+    } else
+#endif
+    {
+        oui_size = mpack_expect_bin_max(reader, DICT_MAX_RECORDS * DICT_OUI_LEN);
+        view->ouis = mpack_read_bytes_inplace(reader, oui_size);
+        mpack_done_bin(reader);
+    }
+    if (oui_size % DICT_OUI_LEN != 0) {
+        mpack_reader_flag_error(reader, mpack_error_data);
+    }
+    view->oui_count = (int)(oui_size / DICT_OUI_LEN);
+}
+
+/* up to capacity records of a dictionary array, with or without the dictionaries */
+static int mpack_decode_dict_records(void* buffer, size_t size, wifi_softap_info_t* out_infos, int capacity, int* out_count) {
+
+    mpack_dict_view_t* view = &mpack_dict_view;
+    mpack_reader_t reader;
+    mpack_reader_init_data(&reader, (const char*)buffer, size);
+
+    int has_dict;
+#if !MPACK_READ_TRACKING
+    /* the two prefixes the encoder writes, fixarray and fixint flags, without the reader */
+    uint16_t prefix = size >= 2 ? mpack_load_u16((const char*)buffer) : 0;
+    if (prefix == (0x9400 | MPACK_DICT_FLAG_DICT) || prefix == 0x9200) {
+        has_dict = prefix != 0x9200;
+        reader.data += 2;
+    } else
+#endif
+    {
+        uint32_t fields = mpack_expect_array_range(&reader, 2, 4);
+        uint8_t flags = mpack_expect_u8(&reader);
+        has_dict = (flags & MPACK_DICT_FLAG_DICT) != 0;
+        if ((flags & ~MPACK_DICT_FLAG_DICT) || fields != (has_dict ? 4u : 2u)) {
+            mpack_reader_flag_error(&reader, mpack_error_data);
+        }
+    }
+    if (has_dict) mpack_read_dict_view(&reader, view);
+
+    int count = (int)mpack_expect_array_max(&reader, (uint32_t)capacity);
+    if (has_dict) {
+        for (int i = 0; i < count && mpack_reader_error(&reader) == mpack_ok; i++) {
+            if (read_single_structure_dict_fast(&reader, view, out_infos + i) != 0) {
+                mpack_reader_flag_error(&reader, mpack_error_data);
+            }
+        }
+    } else {
+        for (int i = 0; i < count && mpack_reader_error(&reader) == mpack_ok; i++) {
+            if (read_single_structure_fast(&reader, out_infos + i) != 0) {
+                mpack_reader_flag_error(&reader, mpack_error_data);
+            }
+        }
+    }
+    mpack_done_array(&reader);
+
+    mpack_done_array(&reader);
+
+    mpack_error_t err = mpack_reader_destroy(&reader);
+    if (err != mpack_ok) {
+        fprintf(stderr, "mpack: reader error %d\n", err);
+        return -1;
+    }
+
+    *out_count = count;
+    return 0;
+}
+
+/*
+ * mpack_decode_array_dict
+ *  - input: *buffer, size, dictionary array schema
+ *  - output: wifi_softap_info_t *out_infos (up to MAX_ARRAY), *out_count
+ *  - return: 0 on success, -1 on failure
+ */
+int mpack_decode_array_dict(void* buffer, size_t size, wifi_softap_info_t* out_infos, int* out_count) {
+    if (!buffer || size == 0 || !out_infos || !out_count) return -1;
+    return mpack_decode_dict_records(buffer, size, out_infos, MAX_ARRAY, out_count);
+}
+
+/*
+ * mpack_encode_dict
+ *  - input: wifi_softap_info_t *info
+ *  - output: *out_buffer, *out_size, a dictionary array of one record
+ *  - return: 0 on success, -1 on failure
+ */
+int mpack_encode_dict(const wifi_softap_info_t* info, void* out_buffer, size_t* out_size) {
+    return mpack_encode_array_dict(info, 1, out_buffer, out_size);
+}
+
+/*
+ * mpack_decode_dict
+ *  - input: *buffer, size, a dictionary array of one record
+ *  - output: wifi_softap_info_t *out_info
+ *  - return: 0 on success, -1 on failure
+ */
+int mpack_decode_dict(void* buffer, size_t size, wifi_softap_info_t* out_info) {
+    int count;
+    if (!buffer || size == 0 || !out_info) return -1;
+    if (mpack_decode_dict_records(buffer, size, out_info, 1, &count) != 0) return -1;
+    if (count != 1) {
+        fprintf(stderr, "mpack: expected 1 record, got %d\n", count);
+        return -1;
+    }
+    return 0;
+}
+
+/* ---------- paged writer on a page pool ---------- */
+/*
+ * Growable output without realloc: the writer fills a page from a static,
+ * size-classed pool and, when it is full, chains the next page instead of
+ * copying. Each new page is one class bigger, up to the largest class. The
+ * pages go back to the pool with mpack_page_chain_release (mpack_send_pages
+ * does this after sending).
+ */
+#define MPACK_PAGE_CLASSES 3
+#define MPACK_POOL_PAGE_MIN_SIZE 1024 /* classes: 1, 4 and 16 KiB */
+#define MPACK_PAGES_PER_CLASS 8
+#define MPACK_POOL_PAGE_SIZE(cls) ((size_t)MPACK_POOL_PAGE_MIN_SIZE << (2 * (cls)))
+
+typedef struct mpack_page_t {
+    struct mpack_page_t* next;
+    char* data;
+    size_t size;
+    size_t used;
+    int cls;
+} mpack_page_t;
+
+typedef struct {
+    mpack_page_t* head;
+    mpack_page_t* tail;
+    size_t total; /* bytes in all pages */
+    int count;    /* number of pages */
+} mpack_page_chain_t;
+
+static char mpack_page_data_1k[MPACK_PAGES_PER_CLASS][MPACK_POOL_PAGE_SIZE(0)];
+static char mpack_page_data_4k[MPACK_PAGES_PER_CLASS][MPACK_POOL_PAGE_SIZE(1)];
+static char mpack_page_data_16k[MPACK_PAGES_PER_CLASS][MPACK_POOL_PAGE_SIZE(2)];
+static mpack_page_t mpack_pages[MPACK_PAGE_CLASSES][MPACK_PAGES_PER_CLASS];
+static mpack_page_t* mpack_page_free[MPACK_PAGE_CLASSES];
+static int mpack_page_pool_ready = 0;
+
+static void mpack_page_pool_init(void) {
+    char* data[MPACK_PAGE_CLASSES] = {mpack_page_data_1k[0], mpack_page_data_4k[0], mpack_page_data_16k[0]};
+
+    for (int cls = 0; cls < MPACK_PAGE_CLASSES; cls++) {
+        mpack_page_free[cls] = NULL;
+        for (int i = MPACK_PAGES_PER_CLASS - 1; i >= 0; i--) {
+            mpack_page_t* page = &mpack_pages[cls][i];
+            page->data = data[cls] + (size_t)i * MPACK_POOL_PAGE_SIZE(cls);
+            page->size = MPACK_POOL_PAGE_SIZE(cls);
+            page->cls = cls;
+            page->next = mpack_page_free[cls];
+            mpack_page_free[cls] = page;
+        }
+    }
+    mpack_page_pool_ready = 1;
+}
+
+/* takes a page of class cls, or the nearest class that has one left */
+static mpack_page_t* mpack_page_acquire(int cls) {
+    if (!mpack_page_pool_ready) mpack_page_pool_init();
+
+    for (int i = 0; i < 2 * MPACK_PAGE_CLASSES; i++) {
+        /* cls, cls + 1, ... then cls - 1, cls - 2, ... */
+        int c = i < MPACK_PAGE_CLASSES - cls ? cls + i : MPACK_PAGE_CLASSES - 1 - i;
+        if (c < 0) break;
+        mpack_page_t* page = mpack_page_free[c];
+        if (page) {
+            mpack_page_free[c] = page->next;
+            page->next = NULL;
+            page->used = 0;
+            return page;
+        }
+    }
+    return NULL;
+}
+
+/* returns every page of the chain to the pool and empties the chain */
+void mpack_page_chain_release(mpack_page_chain_t* chain) {
+    if (!chain) return;
+
+    mpack_page_t* page = chain->head;
+    while (page) {
+        mpack_page_t* next = page->next;
+        page->next = mpack_page_free[page->cls];
+        mpack_page_free[page->cls] = page;
+        page = next;
+    }
+    memset(chain, 0, sizeof(*chain));
+}
+
+/* commits used bytes of the tail page and points the writer at a new page */
+static int mpack_paged_writer_next(mpack_writer_t* writer, mpack_page_chain_t* chain, size_t used) {
+    chain->tail->used = used;
+    chain->total += used;
+
+    int cls = chain->tail->cls + 1;
+    if (cls >= MPACK_PAGE_CLASSES) cls = MPACK_PAGE_CLASSES - 1;
+    mpack_page_t* page = mpack_page_acquire(cls);
+    if (!page) {
+        mpack_writer_flag_error(writer, mpack_error_memory);
+        return -1;
+    }
+
+    chain->tail->next = page;
+    chain->tail = page;
+    chain->count++;
+    writer->buffer = writer->position = page->data;
+    writer->end = page->data + page->size;
+    return 0;
+}
+
+/*
+ * Intrusive flush, like mpack_growable_writer_flush: it is called
+ *  - with the page when it is full (position is reset, count is its data):
+ *    the page is kept and a new one chained
+ *  - with extra data that does not fit in what is left: it is copied
+ *    across as many new pages as needed
+ *  - with the page at mpack_writer_destroy (count is all of its data)
+ */
+static void mpack_paged_writer_flush(mpack_writer_t* writer, const char* data, size_t count) {
+    mpack_page_chain_t* chain = (mpack_page_chain_t*)mpack_writer_context(writer);
+
+    if (data == writer->buffer) {
+        if (mpack_writer_buffer_used(writer) == count) {
+            /* teardown: the data stays in the page */
+            chain->tail->used = count;
+            chain->total += count;
+            return;
+        }
+        mpack_paged_writer_next(writer, chain, count);
+        return;
+    }
+
+    while (count > 0) {
+        size_t step = mpack_writer_buffer_left(writer);
+        if (step > count) step = count;
+        memcpy(writer->position, data, step);
+        writer->position += step;
+        data += step;
+        count -= step;
+        if (count > 0 && mpack_paged_writer_next(writer, chain, mpack_writer_buffer_used(writer)) != 0) return;
+    }
+}
+
+/*
+ * mpack_writer_init_paged
+ *  - input: mpack_writer_t *writer, mpack_page_chain_t *chain (emptied)
+ *  - the writer grows chain page by page; after mpack_writer_destroy the
+ *    chain holds the message. Release it even on error
+ */
+void mpack_writer_init_paged(mpack_writer_t* writer, mpack_page_chain_t* chain) {
+    memset(chain, 0, sizeof(*chain));
+
+    mpack_page_t* page = mpack_page_acquire(0);
+    if (!page) {
+        mpack_writer_init_error(writer, mpack_error_memory);
+        return;
+    }
+    chain->head = chain->tail = page;
+    chain->count = 1;
+
+    mpack_writer_init(writer, page->data, page->size);
+    mpack_writer_set_context(writer, chain);
+    mpack_writer_set_flush(writer, mpack_paged_writer_flush);
+}
+
+/*
+ * mpack_encode_paged
+ *  - input: wifi_softap_info_t *info
+ *  - output: *out_chain, pages holding the message
+ *  - return: 0 on success, -1 on failure (out_chain is then released)
+ */
+int mpack_encode_paged(const wifi_softap_info_t* info, mpack_page_chain_t* out_chain) {
+    if (!info || !out_chain) return -1;
+
+    mpack_writer_t writer;
+    mpack_writer_init_paged(&writer, out_chain);
+
+    write_single_structure_compiled(&writer, info);
+
+    mpack_error_t err = mpack_writer_destroy(&writer);
+    if (err != mpack_ok) {
+        fprintf(stderr, "mpack: writer error %d\n", err);
+        mpack_page_chain_release(out_chain);
+        return -1;
+    }
+
+    return 0;
+}
+
+/*
+ * mpack_encode_array_paged
+ *  - input: infos, count (not limited by MAX_BUFFER)
+ *  - output: *out_chain, pages holding the message
+ *  - return: 0 on success, -1 on failure (out_chain is then released)
+ */
+int mpack_encode_array_paged(const wifi_softap_info_t* infos, int count, mpack_page_chain_t* out_chain) {
+    if (!infos || count == 0 || !out_chain) return -1;
+
+    mpack_writer_t writer;
+    mpack_writer_init_paged(&writer, out_chain);
+
+    write_structure_array_presized(&writer, infos, count);
+
+    mpack_error_t err = mpack_writer_destroy(&writer);
+    if (err != mpack_ok) {
+        fprintf(stderr, "mpack: writer error %d\n", err);
+        mpack_page_chain_release(out_chain);
+        return -1;
+    }
+
+    return 0;
+}
+
+/*
+ * mpack_send_pages
+ *  - sends the chain as one frame (socket_sendv, one piece per page), then
+ *    returns its pages to the pool
+ *  - return: 0 on success, -1 on failure
+ */
+int mpack_send_pages(const char* host, const char* portstr, mpack_page_chain_t* chain) {
+    if (!host || !portstr || !chain || !chain->head) return -1;
+
+    struct iovec iov[MPACK_PAGE_CLASSES * MPACK_PAGES_PER_CLASS];
+    int n = 0;
+    for (mpack_page_t* page = chain->head; page; page = page->next) {
+        iov[n].iov_base = page->data;
+        iov[n].iov_len = page->used;
+        n++;
+    }
+
+    int ret = socket_sendv(host, portstr, iov, n);
+    mpack_page_chain_release(chain);
+    return ret;
+}
+
 #endif /* MPACK_USAGE_H */
\ No newline at end of file
@@ -0,0 +1,608 @@
+#!/usr/bin/env python3
+"""fastpb_generator.py - straight-line encoders/decoders for nanopb messages
+
+Usage (in the nanopb folder, after nanopb_generator.py):
+    python3 fastpb_generator.py sample_structure.proto
+
+Reads the .proto (and <name>.options, if present) and writes
+<name>.fastpb.h / <name>.fastpb.c next to it.
+For every message M (C type <package>_M from <name>.pb.h) it emits
+
+    size_t M_fast_size(const M *msg);          exact encoded size, SIZE_MAX if invalid
+    bool M_fast_encode(const M *msg, pb_byte_t *buf, size_t bufsize, size_t *written);
+    bool M_fast_decode(M *msg, const pb_byte_t *buf, size_t size);
+
+The output is byte-identical to pb_encode() and the decoder accepts and
+rejects the same input as pb_decode(), but there is no field descriptor
+walk: every field is a fixed piece of code with constant tag bytes.
+The size pass keeps each submessage length in a stack array
+(M_FASTPB_SUBMSGS entries) and the write pass takes them from there, so
+a nested message is measured once, not once per level above it.
+
+Only the static allocation types used by our schemas are supported:
+(s|u)int32/64 and bool scalars, bytes with max_size (fixed_length:true
+gives a plain pb_byte_t array, like nanopb_generator.py), singular and
+repeated (max_count) submessages. Anything else is an error.
+"""
+
+import os
+import re
+import sys
+
+SCALARS = {
+    # proto type: value kind
+    "int32": "int32",
+    "int64": "int64",
+    "uint32": "uint32",
+    "uint64": "uint64",
+    "sint32": "sint32",
+    "sint64": "sint64",
+    "bool": "bool",
+}
+
+WT_VARINT = 0
+WT_STRING = 2
+
+
+class Field:
+    def __init__(self, label, ftype, name, tag):
+        self.label = label
+        self.ftype = ftype
+        self.name = name
+        self.tag = tag
+        self.fixed_length = False
+
+    @property
+    def is_message(self):
+        return self.ftype not in SCALARS and self.ftype != "bytes"
+
+    @property
+    def wire_type(self):
+        return WT_VARINT if self.ftype in SCALARS else WT_STRING
+
+
+class Message:
+    def __init__(self, name, cname):
+        self.name = name
+        self.cname = cname
+        self.fields = []
+
+
+def strip_comments(text):
+    text = re.sub(r"/\*.*?\*/", "", text, flags=re.S)
+    return re.sub(r"//[^\n]*", "", text)
+
+
+def parse_proto(text):
+    text = strip_comments(text)
+    m = re.search(r"\bpackage\s+([\w.]+)\s*;", text)
+    package = m.group(1).replace(".", "_") if m else ""
+    messages = []
+    for m in re.finditer(r"\bmessage\s+(\w+)\s*\{([^{}]*)\}", text):
+        name = m.group(1)
+        cname = package + "_" + name if package else name
+        msg = Message(name, cname)
+        for f in re.finditer(r"(?:(repeated|optional)\s+)?([\w.]+)\s+(\w+)\s*=\s*(\d+)\s*;", m.group(2)):
+            msg.fields.append(Field(f.group(1) or "", f.group(2), f.group(3), int(f.group(4))))
+        msg.fields.sort(key=lambda fld: fld.tag)  # nanopb encodes in tag order
+        messages.append(msg)
+    if re.search(r"\b(enum|oneof|map\s*<)", text):
+        sys.exit("fastpb_generator: enum/oneof/map are not supported")
+    return package, messages
+
+
+def parse_options(text, messages):
+    """fixed_length:true from a nanopb .options file, other options are
+    already reflected in the generated .pb.h"""
+    fields = {}
+    for msg in messages:
+        for f in msg.fields:
+            fields["%s.%s" % (msg.name, f.name)] = f
+    for line in text.split("\n"):
+        words = line.split("#", 1)[0].split()
+        if not words:
+            continue
+        key = ".".join(words[0].split(".")[-2:])  # package.Message.field
+        if key in fields and "fixed_length:true" in words[1:]:
+            f = fields[key]
+            if f.ftype != "bytes" or not any(w.startswith("max_size:") for w in words[1:]):
+                sys.exit("fastpb_generator: fixed_length needs bytes with max_size (%s)" % words[0])
+            f.fixed_length = True
+
+
+def varint_bytes(value):
+    out = []
+    while True:
+        byte = value & 0x7F
+        value >>= 7
+        if value:
+            out.append(byte | 0x80)
+        else:
+            out.append(byte)
+            return out
+
+
+def tag_bytes(field):
+    return varint_bytes((field.tag << 3) | field.wire_type)
+
+
+def c_bytes(values):
+    return ", ".join("0x%02x" % v for v in values)
+
+
+PREAMBLE_C = r"""
+/* ---------- wire helpers ---------- */
+static inline size_t fastpb_varint_size(uint64_t value) {
+    size_t size = 1;
+    while (value > 0x7F) {
+        value >>= 7;
+        size++;
+    }
+    return size;
+}
+
+static inline pb_byte_t* fastpb_put_varint(pb_byte_t* p, uint64_t value) {
+    while (value > 0x7F) {
+        *p++ = (pb_byte_t)(value | 0x80);
+        value >>= 7;
+    }
+    *p++ = (pb_byte_t)value;
+    return p;
+}
+
+static inline pb_byte_t* fastpb_put_tag(pb_byte_t* p, const pb_byte_t* tag, size_t size) {
+    memcpy(p, tag, size);
+    return p + size;
+}
+
+/* same limits as pb_decode_varint32() */
+static inline bool fastpb_get_varint32(const pb_byte_t** pp, const pb_byte_t* end, uint32_t* dest) {
+    const pb_byte_t* p = *pp;
+    pb_byte_t byte;
+    uint32_t result;
+
+    if (p >= end) return false;
+    byte = *p++;
+    result = byte & 0x7F;
+    if (byte & 0x80) {
+        unsigned bitpos = 7;
+        do {
+            if (p >= end) return false;
+            byte = *p++;
+            if (bitpos >= 32) {
+                /* trailing 0x80 bytes, or 0xFF for a negative value */
+                pb_byte_t sign_extension = (bitpos < 63) ? 0xFF : 0x01;
+                bool valid_extension = ((byte & 0x7F) == 0x00 || ((result >> 31) != 0 && byte == sign_extension));
+                if (bitpos >= 64 || !valid_extension) return false;
+            } else if (bitpos == 28) {
+                if ((byte & 0x70) != 0 && (byte & 0x78) != 0x78) return false;
+                result |= (uint32_t)(byte & 0x0F) << bitpos;
+            } else {
+                result |= (uint32_t)(byte & 0x7F) << bitpos;
+            }
+            bitpos += 7;
+        } while (byte & 0x80);
+    }
+
+    *dest = result;
+    *pp = p;
+    return true;
+}
+
+/* same limits as pb_decode_varint() */
+static inline bool fastpb_get_varint(const pb_byte_t** pp, const pb_byte_t* end, uint64_t* dest) {
+    const pb_byte_t* p = *pp;
+    unsigned bitpos = 0;
+    uint64_t result = 0;
+    pb_byte_t byte;
+
+    do {
+        if (p >= end) return false;
+        byte = *p++;
+        if (bitpos >= 63 && (byte & 0xFE) != 0) return false;
+        result |= (uint64_t)(byte & 0x7F) << bitpos;
+        bitpos += 7;
+    } while (byte & 0x80);
+
+    *dest = result;
+    *pp = p;
+    return true;
+}
+
+/* same as pb_skip_field() */
+static inline bool fastpb_skip(const pb_byte_t** pp, const pb_byte_t* end, unsigned wire_type) {
+    const pb_byte_t* p = *pp;
+    uint32_t len;
+
+    switch (wire_type) {
+        case 0: /* varint */
+            do {
+                if (p >= end) return false;
+            } while (*p++ & 0x80);
+            break;
+        case 1: /* 64-bit */
+            if (end - p < 8) return false;
+            p += 8;
+            break;
+        case 2: /* length-delimited */
+            if (!fastpb_get_varint32(&p, end, &len)) return false;
+            if ((size_t)(end - p) < len) return false;
+            p += len;
+            break;
+        case 5: /* 32-bit */
+            if (end - p < 4) return false;
+            p += 4;
+            break;
+        default:
+            return false;
+    }
+
+    *pp = p;
+    return true;
+}
+
+/* byte count of a static bytes field, as checked by pb_enc_bytes() */
+#define FASTPB_BYTES_MAX(field) (sizeof(field) - offsetof(pb_bytes_array_t, bytes))
+"""
+
+
+def scalar_value_expr(field, ref):
+    kind = SCALARS[field.ftype]
+    if kind in ("int32", "int64"):
+        return "(uint64_t)(int64_t)%s" % ref
+    if kind == "sint32":
+        return "(uint64_t)(((uint32_t)%s << 1) ^ (uint32_t)(%s >> 31))" % (ref, ref)
+    if kind == "sint64":
+        return "(((uint64_t)%s << 1) ^ (uint64_t)(%s >> 63))" % (ref, ref)
+    if kind == "bool":
+        return "(uint64_t)(%s ? 1 : 0)" % ref
+    return "(uint64_t)%s" % ref
+
+
+class Generator:
+    def __init__(self, package, messages):
+        self.package = package
+        self.messages = messages
+        self.by_name = {m.name: m for m in messages}
+
+    def submsg(self, field):
+        name = field.ftype.split(".")[-1]
+        if name not in self.by_name:
+            sys.exit("fastpb_generator: unknown type %s" % field.ftype)
+        return self.by_name[name]
+
+    def check(self):
+        for msg in self.messages:
+            for f in msg.fields:
+                if f.label == "repeated" and not f.is_message:
+                    sys.exit("fastpb_generator: repeated %s %s.%s is not supported" % (f.ftype, msg.name, f.name))
+                if f.label == "optional" and not f.is_message:
+                    sys.exit("fastpb_generator: proto3 optional %s.%s is not supported" % (msg.name, f.name))
+                if f.is_message:
+                    self.submsg(f)
+
+    def has_submsgs(self, msg):
+        return any(f.is_message for f in msg.fields)
+
+    # ---- size ----
+    def gen_submsgs(self, msg):
+        """upper bound of the submessage lengths M_fast_measure() records"""
+        terms = []
+        for f in msg.fields:
+            if not f.is_message:
+                continue
+            sub = self.submsg(f)
+            if f.label == "repeated":
+                terms.append("pb_arraysize(%s, %s) * (1 + %s_FASTPB_SUBMSGS)" % (msg.cname, f.name, sub.cname))
+            else:
+                terms.append("1 + %s_FASTPB_SUBMSGS" % sub.cname)
+        return ["#define %s_FASTPB_SUBMSGS (%s)" % (msg.cname, " + ".join(terms) or "0")]
+
+    def gen_size(self, msg):
+        """M_fast_measure() stores every submessage length in *sizes, in the
+        order M_fast_write() writes them, so no length is computed twice"""
+        out = []
+        out.append("static size_t %s_fast_measure(const %s* msg, size_t** sizes) {" % (msg.cname, msg.cname))
+        out.append("    size_t size = 0;")
+        if not self.has_submsgs(msg):
+            out.append("    (void)sizes;")
+        for f in msg.fields:
+            ntag = len(tag_bytes(f))
+            ref = "msg->%s" % f.name
+            if f.ftype in SCALARS:
+                out.append("    if (%s) size += %d + fastpb_varint_size(%s);" % (ref, ntag, scalar_value_expr(f, ref)))
+            elif f.fixed_length:
+                out.append("    size += %d + fastpb_varint_size(sizeof(%s)) + sizeof(%s);" % (ntag, ref, ref))
+            elif f.ftype == "bytes":
+                out.append("    if (%s.size > FASTPB_BYTES_MAX(%s)) return SIZE_MAX;" % (ref, ref))
+                out.append("    if (%s.size) size += %d + fastpb_varint_size(%s.size) + %s.size;" % (ref, ntag, ref, ref))
+            elif f.label == "repeated":
+                sub = self.submsg(f)
+                out.append("    if (msg->%s_count > pb_arraysize(%s, %s)) return SIZE_MAX;" % (f.name, msg.cname, f.name))
+                out.append("    for (pb_size_t i = 0; i < msg->%s_count; i++) {" % f.name)
+                out.append("        size_t* slot = (*sizes)++;")
+                out.append("        size_t sub = %s_fast_measure(&%s[i], sizes);" % (sub.cname, ref))
+                out.append("        if (sub == SIZE_MAX) return SIZE_MAX;")
+                out.append("        *slot = sub;")
+                out.append("        size += %d + fastpb_varint_size(sub) + sub;" % ntag)
+                out.append("    }")
+            else:
+                sub = self.submsg(f)
+                out.append("    if (msg->has_%s) {" % f.name)
+                out.append("        size_t* slot = (*sizes)++;")
+                out.append("        size_t sub = %s_fast_measure(&%s, sizes);" % (sub.cname, ref))
+                out.append("        if (sub == SIZE_MAX) return SIZE_MAX;")
+                out.append("        *slot = sub;")
+                out.append("        size += %d + fastpb_varint_size(sub) + sub;" % ntag)
+                out.append("    }")
+        out.append("    return size;")
+        out.append("}")
+        out.append("")
+        out.append("size_t %s_fast_size(const %s* msg) {" % (msg.cname, msg.cname))
+        out.append("    size_t sizes[%s_FASTPB_SUBMSGS + 1];" % msg.cname)
+        out.append("    size_t* next = sizes;")
+        out.append("    return %s_fast_measure(msg, &next);" % msg.cname)
+        out.append("}")
+        return out
+
+    # ---- write (unchecked, size and *sizes from M_fast_measure) ----
+    def gen_write(self, msg):
+        out = []
+        out.append("static pb_byte_t* %s_fast_write(const %s* msg, pb_byte_t* p, const size_t** sizes) {" % (msg.cname, msg.cname))
+        for f in msg.fields:
+            tb = tag_bytes(f)
+            tag_name = "%s_%s_fasttag" % (msg.cname, f.name)
+            out.append("    static const pb_byte_t %s[] = {%s};" % (tag_name, c_bytes(tb)))
+        if not self.has_submsgs(msg):
+            out.append("    (void)sizes;")
+        for f in msg.fields:
+            tag_name = "%s_%s_fasttag" % (msg.cname, f.name)
+            ntag = len(tag_bytes(f))
+            ref = "msg->%s" % f.name
+            if f.ftype in SCALARS:
+                out.append("    if (%s) {" % ref)
+                out.append("        p = fastpb_put_tag(p, %s, %d);" % (tag_name, ntag))
+                out.append("        p = fastpb_put_varint(p, %s);" % scalar_value_expr(f, ref))
+                out.append("    }")
+            elif f.fixed_length:
+                out.append("    p = fastpb_put_tag(p, %s, %d);" % (tag_name, ntag))
+                out.append("    p = fastpb_put_varint(p, sizeof(%s));" % ref)
+                out.append("    memcpy(p, %s, sizeof(%s));" % (ref, ref))
+                out.append("    p += sizeof(%s);" % ref)
+            elif f.ftype == "bytes":
+                out.append("    if (%s.size) {" % ref)
+                out.append("        p = fastpb_put_tag(p, %s, %d);" % (tag_name, ntag))
+                out.append("        p = fastpb_put_varint(p, %s.size);" % ref)
+                out.append("        memcpy(p, %s.bytes, %s.size);" % (ref, ref))
+                out.append("        p += %s.size;" % ref)
+                out.append("    }")
+            elif f.label == "repeated":
+                sub = self.submsg(f)
+                out.append("    for (pb_size_t i = 0; i < msg->%s_count; i++) {" % f.name)
+                out.append("        p = fastpb_put_tag(p, %s, %d);" % (tag_name, ntag))
+                out.append("        p = fastpb_put_varint(p, *(*sizes)++);")
+                out.append("        p = %s_fast_write(&%s[i], p, sizes);" % (sub.cname, ref))
+                out.append("    }")
+            else:
+                sub = self.submsg(f)
+                out.append("    if (msg->has_%s) {" % f.name)
+                out.append("        p = fastpb_put_tag(p, %s, %d);" % (tag_name, ntag))
+                out.append("        p = fastpb_put_varint(p, *(*sizes)++);")
+                out.append("        p = %s_fast_write(&%s, p, sizes);" % (sub.cname, ref))
+                out.append("    }")
+        out.append("    return p;")
+        out.append("}")
+        return out
+
+    def gen_encode(self, msg):
+        return [
+            "bool %s_fast_encode(const %s* msg, pb_byte_t* buf, size_t bufsize, size_t* written) {" % (msg.cname, msg.cname),
+            "    size_t sizes[%s_FASTPB_SUBMSGS + 1];" % msg.cname,
+            "    size_t* next = sizes;",
+            "    const size_t* cached = sizes;",
+            "    size_t size = %s_fast_measure(msg, &next);" % msg.cname,
+            "    if (size == SIZE_MAX || size > bufsize) return false;",
+            "    %s_fast_write(msg, buf, &cached);" % msg.cname,
+            "    if (written) *written = size;",
+            "    return true;",
+            "}",
+        ]
+
+    # ---- read ----
+    def gen_read(self, msg):
+        out = []
+        out.append("static bool %s_fast_read(%s* msg, const pb_byte_t* p, const pb_byte_t* end) {" % (msg.cname, msg.cname))
+        out.append("    while (p < end) {")
+        out.append("        uint32_t tag;")
+        if any(f.ftype not in SCALARS or f.ftype == "bool" for f in msg.fields):
+            out.append("        uint32_t len;")
+        if any(f.ftype in SCALARS and f.ftype != "bool" for f in msg.fields):
+            out.append("        uint64_t value;")
+        out.append("        if (!fastpb_get_varint32(&p, end, &tag)) return false;")
+        out.append("        switch (tag) {")
+        for f in msg.fields:
+            ref = "msg->%s" % f.name
+            out.append("            case (%du << 3) | %d:" % (f.tag, f.wire_type))
+            if f.ftype in SCALARS:
+                kind = SCALARS[f.ftype]
+                if kind == "bool":
+                    out.append("                if (!fastpb_get_varint32(&p, end, &len)) return false;")
+                    out.append("                %s = (len != 0);" % ref)
+                else:
+                    out.append("                if (!fastpb_get_varint(&p, end, &value)) return false;")
+                    if kind == "int32":
+                        out.append("                %s = (int32_t)value;" % ref)
+                    elif kind == "int64":
+                        out.append("                %s = (int64_t)value;" % ref)
+                    elif kind == "uint32":
+                        out.append("                if (value > UINT32_MAX) return false;")
+                        out.append("                %s = (uint32_t)value;" % ref)
+                    elif kind == "uint64":
+                        out.append("                %s = value;" % ref)
+                    elif kind == "sint32":
+                        out.append("                {")
+                        out.append("                    int64_t svalue = (int64_t)((value >> 1) ^ (~(value & 1) + 1));")
+                        out.append("                    if (svalue != (int32_t)svalue) return false;")
+                        out.append("                    %s = (int32_t)svalue;" % ref)
+                        out.append("                }")
+                    elif kind == "sint64":
+                        out.append("                %s = (int64_t)((value >> 1) ^ (~(value & 1) + 1));" % ref)
+                out.append("                break;")
+            elif f.fixed_length:
+                out.append("                if (!fastpb_get_varint32(&p, end, &len)) return false;")
+                out.append("                if (len == 0) {")
+                out.append("                    memset(%s, 0, sizeof(%s)); /* empty means all zeros, like pb_decode */" % (ref, ref))
+                out.append("                    break;")
+                out.append("                }")
+                out.append("                if (len != sizeof(%s) || (size_t)(end - p) < len) return false;" % ref)
+                out.append("                memcpy(%s, p, len);" % ref)
+                out.append("                p += len;")
+                out.append("                break;")
+            elif f.ftype == "bytes":
+                out.append("                if (!fastpb_get_varint32(&p, end, &len)) return false;")
+                out.append("                if (len > PB_SIZE_MAX || PB_BYTES_ARRAY_T_ALLOCSIZE(len) > sizeof(%s)) return false;" % ref)
+                out.append("                if ((size_t)(end - p) < len) return false;")
+                out.append("                %s.size = (pb_size_t)len;" % ref)
+                out.append("                memcpy(%s.bytes, p, len);" % ref)
+                out.append("                p += len;")
+                out.append("                break;")
+            elif f.label == "repeated":
+                sub = self.submsg(f)
+                out.append("                if (!fastpb_get_varint32(&p, end, &len)) return false;")
+                out.append("                if ((size_t)(end - p) < len) return false;")
+                out.append("                if (msg->%s_count >= pb_arraysize(%s, %s)) return false;" % (f.name, msg.cname, f.name))
+                out.append("                memset(&%s[msg->%s_count], 0, sizeof(%s[0]));" % (ref, f.name, ref))
+                out.append("                if (!%s_fast_read(&%s[msg->%s_count++], p, p + len)) return false;" % (sub.cname, ref, f.name))
+                out.append("                p += len;")
+                out.append("                break;")
+            else:
+                sub = self.submsg(f)
+                out.append("                if (!fastpb_get_varint32(&p, end, &len)) return false;")
+                out.append("                if ((size_t)(end - p) < len) return false;")
+                out.append("                msg->has_%s = true; /* merged like pb_decode, not reset */" % f.name)
+                out.append("                if (!%s_fast_read(&%s, p, p + len)) return false;" % (sub.cname, ref))
+                out.append("                p += len;")
+                out.append("                break;")
+        out.append("            default:")
+        known = " || ".join("(tag >> 3) == %du" % f.tag for f in msg.fields) or "0"
+        out.append("                if (tag >> 3 == 0) return false; /* zero tag */")
+        out.append("                if (%s) return false; /* wrong wire type */" % known)
+        out.append("                if (!fastpb_skip(&p, end, tag & 7)) return false;")
+        out.append("                break;")
+        out.append("        }")
+        out.append("    }")
+        out.append("    return true;")
+        out.append("}")
+        return out
+
+    def gen_decode(self, msg):
+        return [
+            "bool %s_fast_decode(%s* msg, const pb_byte_t* buf, size_t size) {" % (msg.cname, msg.cname),
+            "    memset(msg, 0, sizeof(*msg));",
+            "    return %s_fast_read(msg, buf, buf + size);" % msg.cname,
+            "}",
+        ]
+
+    def order(self):
+        """submessages before the messages that use them"""
+        done, out = set(), []
+
+        def visit(msg):
+            if msg.name in done:
+                return
+            done.add(msg.name)
+            for f in msg.fields:
+                if f.is_message:
+                    visit(self.submsg(f))
+            out.append(msg)
+
+        for msg in self.messages:
+            visit(msg)
+        return out
+
+    def header(self, base, guard):
+        out = [
+            "/* Automatically generated by fastpb_generator.py from %s.proto */" % base,
+            "/* Straight-line encoders/decoders, wire-compatible with pb_encode/pb_decode */",
+            "",
+            "#ifndef %s" % guard,
+            "#define %s" % guard,
+            "#include <stdbool.h>",
+            "#include <stddef.h>",
+            '#include "%s.pb.h"' % base,
+            "",
+            "#ifdef __cplusplus",
+            'extern "C" {',
+            "#endif",
+            "",
+        ]
+        for msg in self.messages:
+            out.append("size_t %s_fast_size(const %s* msg);" % (msg.cname, msg.cname))
+            out.append("bool %s_fast_encode(const %s* msg, pb_byte_t* buf, size_t bufsize, size_t* written);" % (msg.cname, msg.cname))
+            out.append("bool %s_fast_decode(%s* msg, const pb_byte_t* buf, size_t size);" % (msg.cname, msg.cname))
+            out.append("")
+        out += [
+            "#ifdef __cplusplus",
+            '} /* extern "C" */',
+            "#endif",
+            "",
+            "#endif",
+            "",
+        ]
+        return out
+
+    def source(self, base):
+        out = [
+            "/* Automatically generated by fastpb_generator.py from %s.proto */" % base,
+            "/* Straight-line encoders/decoders, wire-compatible with pb_encode/pb_decode */",
+            "",
+            "#include <stdint.h>",
+            "#include <string.h>",
+            '#include "%s.fastpb.h"' % base,
+        ]
+        out += PREAMBLE_C.rstrip("\n").split("\n")
+        ordered = self.order()
+        for msg in ordered:
+            out.append("")
+            out.append("/* ---------- %s ---------- */" % msg.cname)
+            out += self.gen_submsgs(msg)
+            out.append("")
+            out += self.gen_size(msg)
+            out.append("")
+            out += self.gen_write(msg)
+            out.append("")
+            out += self.gen_read(msg)
+            out.append("")
+            out += self.gen_encode(msg)
+            out.append("")
+            out += self.gen_decode(msg)
+        out.append("")
+        return out
+
+
+def main(argv):
+    if len(argv) != 2:
+        sys.exit("usage: %s file.proto" % argv[0])
+    path = argv[1]
+    with open(path) as fh:
+        package, messages = parse_proto(fh.read())
+
+    options = os.path.splitext(path)[0] + ".options"
+    if os.path.exists(options):
+        with open(options) as fh:
+            parse_options(fh.read(), messages)
+
+    gen = Generator(package, messages)
+    gen.check()
+
+    base = os.path.splitext(os.path.basename(path))[0]
+    outdir = os.path.dirname(path) or "."
+    guard = "PB_%s_%s_FASTPB_H_INCLUDED" % (package.upper(), base.upper())
+    with open(os.path.join(outdir, base + ".fastpb.h"), "w") as fh:
+        fh.write("\n".join(gen.header(base, guard)))
+    with open(os.path.join(outdir, base + ".fastpb.c"), "w") as fh:
+        fh.write("\n".join(gen.source(base)))
+
+
+if __name__ == "__main__":
+    main(sys.argv)
@@ -62,6 +62,27 @@ typedef struct {
     uint32_t bitfield[(PB_MAX_REQUIRED_FIELDS + 31) / 32];
 } pb_fields_seen_t;
 
+/* Word-at-a-time varint decoding for buffer streams: one unaligned 8 byte
+ * load, the terminating byte is found from the cleared high bits and the
+ * 7 bit groups are compacted with PEXT (BMI2) or three mask-and-shift steps.
+ * Used only when at least 8 bytes are left in a buffer stream; callback
+ * streams, buffer ends and varints longer than the fast path handles go
+ * through the byte loop. Define PB_NO_FAST_VARINT to disable. */
+#if !defined(PB_NO_FAST_VARINT) && !defined(PB_WITHOUT_64BIT) && \
+    defined(__GNUC__) && defined(__BYTE_ORDER__) && __BYTE_ORDER__ == __ORDER_LITTLE_ENDIAN__
+#define PB_FAST_VARINT 1
+#ifdef __BMI2__
+#include <immintrin.h>
+#endif
+#ifdef PB_BUFFER_ONLY
+#define PB_IS_BUFFER_ISTREAM(stream) true
+#else
+#define PB_IS_BUFFER_ISTREAM(stream) ((stream)->callback == buf_read)
+#endif
+#else
+#define PB_FAST_VARINT 0
+#endif
+
 /*******************************
  * pb_istream_t implementation *
  *******************************/
@@ -168,11 +189,55 @@ pb_istream_t pb_istream_from_buffer(const pb_byte_t *buf, size_t msglen)
  * Helper functions *
  ********************/
 
+#if PB_FAST_VARINT
+/* Decode a varint from 8 readable bytes at buf.
+ * Returns its length (1-8), or 0 if it is longer than 8 bytes. */
+static size_t pb_decode_varint_word(const pb_byte_t *buf, uint64_t *dest)
+{
+    uint64_t word;
+    uint64_t stops;
+
+    memcpy(&word, buf, sizeof(word));
+    stops = ~word & 0x8080808080808080ULL;
+    if (stops == 0)
+        return 0;
+
+    /* Keep the bytes up to and including the first one without 0x80 */
+    word &= (stops ^ (stops - 1)) & 0x7F7F7F7F7F7F7F7FULL;
+#ifdef __BMI2__
+    *dest = _pext_u64(word, 0x7F7F7F7F7F7F7F7FULL);
+#else
+    word = (word & 0x007F007F007F007FULL) | ((word & 0x7F007F007F007F00ULL) >> 1);
+    word = (word & 0x00003FFF00003FFFULL) | ((word & 0x3FFF00003FFF0000ULL) >> 2);
+    word = (word & 0x000000000FFFFFFFULL) | ((word & 0x0FFFFFFF00000000ULL) >> 4);
+    *dest = word;
+#endif
+    return (size_t)(__builtin_ctzll(stops) + 1) / 8;
+}
+#endif
+
 static bool checkreturn pb_decode_varint32_eof(pb_istream_t *stream, uint32_t *dest, bool *eof)
 {
     pb_byte_t byte;
     uint32_t result;
     
+#if PB_FAST_VARINT
+    if (PB_IS_BUFFER_ISTREAM(stream) && stream->bytes_left >= 8)
+    {
+        uint64_t value;
+        size_t len = pb_decode_varint_word((const pb_byte_t*)stream->state, &value);
+
+        /* Up to 4 bytes (28 bits) needs none of the 32 bit overflow checks */
+        if (len != 0 && len <= 4)
+        {
+            stream->state = (pb_byte_t*)stream->state + len;
+            stream->bytes_left -= len;
+            *dest = (uint32_t)value;
+            return true;
+        }
+    }
+#endif
+
     if (!pb_readbyte(stream, &byte))
     {
         if (stream->bytes_left == 0)
@@ -246,6 +311,20 @@ bool checkreturn pb_decode_varint(pb_istream_t *stream, uint64_t *dest)
     uint_fast8_t bitpos = 0;
     uint64_t result = 0;
     
+#if PB_FAST_VARINT
+    if (PB_IS_BUFFER_ISTREAM(stream) && stream->bytes_left >= 8)
+    {
+        /* Up to 8 bytes (56 bits) can't overflow */
+        size_t len = pb_decode_varint_word((const pb_byte_t*)stream->state, dest);
+        if (len != 0)
+        {
+            stream->state = (pb_byte_t*)stream->state + len;
+            stream->bytes_left -= len;
+            return true;
+        }
+    }
+#endif
+
     do
     {
         if (!pb_readbyte(stream, &byte))
@@ -754,6 +833,12 @@ static bool checkreturn decode_callback_field(pb_istream_t *stream, pb_wire_type
     if (!field->descriptor->field_callback)
         return pb_skip_field(stream, wire_type);
 
+    /* Bytes, strings and submessages are always length-delimited, as
+     * decode_basic_field() checks for static fields. Only the packable
+     * scalar types may reach a callback with another wire type. */
+    if (wire_type != PB_WT_STRING && PB_LTYPE(field->type) > PB_LTYPE_LAST_PACKABLE)
+        PB_RETURN_ERROR(stream, "wrong wire type");
+
     if (wire_type == PB_WT_STRING)
     {
         pb_istream_t substream;
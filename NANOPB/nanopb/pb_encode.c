@@ -46,6 +46,28 @@ static bool checkreturn pb_enc_fixed_length_bytes(pb_ostream_t *stream, const pb
 #define pb_uint64_t uint64_t
 #endif
 
+/* Word-at-a-time varint encoding: the length comes from the highest set bit,
+ * the 7 bit groups are spread with PDEP (BMI2) or three mask-and-shift steps,
+ * continuation bits are or-ed in and the result is written with one 8 byte
+ * store. Used for values below 2^56 when a buffer stream has 8 bytes of room
+ * (bytes past the varint are overwritten by the next write or left unused
+ * beyond bytes_written), and for sizing streams. Callback streams and buffer
+ * ends use the generic code. Define PB_NO_FAST_VARINT to disable. */
+#if !defined(PB_NO_FAST_VARINT) && !defined(PB_WITHOUT_64BIT) && \
+    defined(__GNUC__) && defined(__BYTE_ORDER__) && __BYTE_ORDER__ == __ORDER_LITTLE_ENDIAN__
+#define PB_FAST_VARINT 1
+#ifdef __BMI2__
+#include <immintrin.h>
+#endif
+#ifdef PB_BUFFER_ONLY
+#define PB_IS_BUFFER_OSTREAM(stream) ((stream)->callback != NULL)
+#else
+#define PB_IS_BUFFER_OSTREAM(stream) ((stream)->callback == &buf_write)
+#endif
+#else
+#define PB_FAST_VARINT 0
+#endif
+
 /*******************************
  * pb_ostream_t implementation *
  *******************************/
@@ -606,6 +628,39 @@ static bool checkreturn pb_encode_varint_32(pb_ostream_t *stream, uint32_t low,
 
 bool checkreturn pb_encode_varint(pb_ostream_t *stream, pb_uint64_t value)
 {
+#if PB_FAST_VARINT
+    if (value > 0x7F && value < (1ULL << 56))
+    {
+        size_t len = (size_t)(63 - __builtin_clzll(value)) / 7 + 1;
+
+        if (stream->callback == NULL)
+        {
+            /* Sizing stream */
+            stream->bytes_written += len;
+            return true;
+        }
+
+        if (PB_IS_BUFFER_OSTREAM(stream) &&
+            stream->bytes_written <= stream->max_size &&
+            stream->max_size - stream->bytes_written >= 8)
+        {
+            uint64_t word;
+#ifdef __BMI2__
+            word = _pdep_u64(value, 0x7F7F7F7F7F7F7F7FULL);
+#else
+            word = (value & 0x000000000FFFFFFFULL) | ((value & 0x00FFFFFFF0000000ULL) << 4);
+            word = (word & 0x00003FFF00003FFFULL) | ((word & 0x0FFFC0000FFFC000ULL) << 2);
+            word = (word & 0x007F007F007F007FULL) | ((word & 0x3F803F803F803F80ULL) << 1);
+#endif
+            word |= 0x8080808080808080ULL & ((1ULL << (8 * (len - 1))) - 1);
+            memcpy(stream->state, &word, sizeof(word));
+            stream->state = (pb_byte_t*)stream->state + len;
+            stream->bytes_written += len;
+            return true;
+        }
+    }
+#endif
+
     if (value <= 0x7F)
     {
         /* Fast path: single byte */
@@ -0,0 +1,431 @@
+/* Automatically generated by fastpb_generator.py from sample_structure.proto */
+/* Straight-line encoders/decoders, wire-compatible with pb_encode/pb_decode */
+
+#include <stdint.h>
+#include <string.h>
+#include "sample_structure.fastpb.h"
+
+/* ---------- wire helpers ---------- */
+static inline size_t fastpb_varint_size(uint64_t value) {
+    size_t size = 1;
+    while (value > 0x7F) {
+        value >>= 7;
+        size++;
+    }
+    return size;
+}
+
+static inline pb_byte_t* fastpb_put_varint(pb_byte_t* p, uint64_t value) {
+    while (value > 0x7F) {
+        *p++ = (pb_byte_t)(value | 0x80);
+        value >>= 7;
+    }
+    *p++ = (pb_byte_t)value;
+    return p;
+}
+
+static inline pb_byte_t* fastpb_put_tag(pb_byte_t* p, const pb_byte_t* tag, size_t size) {
+    memcpy(p, tag, size);
+    return p + size;
+}
+
+/* same limits as pb_decode_varint32() */
+static inline bool fastpb_get_varint32(const pb_byte_t** pp, const pb_byte_t* end, uint32_t* dest) {
+    const pb_byte_t* p = *pp;
+    pb_byte_t byte;
+    uint32_t result;
+
+    if (p >= end) return false;
+    byte = *p++;
+    result = byte & 0x7F;
+    if (byte & 0x80) {
+        unsigned bitpos = 7;
+        do {
+            if (p >= end) return false;
+            byte = *p++;
+            if (bitpos >= 32) {
+                /* trailing 0x80 bytes, or 0xFF for a negative value */
+                pb_byte_t sign_extension = (bitpos < 63) ? 0xFF : 0x01;
+                bool valid_extension = ((byte & 0x7F) == 0x00 || ((result >> 31) != 0 && byte == sign_extension));
+                if (bitpos >= 64 || !valid_extension) return false;
+            } else if (bitpos == 28) {
+                if ((byte & 0x70) != 0 && (byte & 0x78) != 0x78) return false;
+                result |= (uint32_t)(byte & 0x0F) << bitpos;
+            } else {
+                result |= (uint32_t)(byte & 0x7F) << bitpos;
+            }
+            bitpos += 7;
+        } while (byte & 0x80);
+    }
+
+    *dest = result;
+    *pp = p;
+    return true;
+}
+
+/* same limits as pb_decode_varint() */
+static inline bool fastpb_get_varint(const pb_byte_t** pp, const pb_byte_t* end, uint64_t* dest) {
+    const pb_byte_t* p = *pp;
+    unsigned bitpos = 0;
+    uint64_t result = 0;
+    pb_byte_t byte;
+
+    do {
+        if (p >= end) return false;
+        byte = *p++;
+        if (bitpos >= 63 && (byte & 0xFE) != 0) return false;
+        result |= (uint64_t)(byte & 0x7F) << bitpos;
+        bitpos += 7;
+    } while (byte & 0x80);
+
+    *dest = result;
+    *pp = p;
+    return true;
+}
+
+/* same as pb_skip_field() */
+static inline bool fastpb_skip(const pb_byte_t** pp, const pb_byte_t* end, unsigned wire_type) {
+    const pb_byte_t* p = *pp;
+    uint32_t len;
+
+    switch (wire_type) {
+        case 0: /* varint */
+            do {
+                if (p >= end) return false;
+            } while (*p++ & 0x80);
+            break;
+        case 1: /* 64-bit */
+            if (end - p < 8) return false;
+            p += 8;
+            break;
+        case 2: /* length-delimited */
+            if (!fastpb_get_varint32(&p, end, &len)) return false;
+            if ((size_t)(end - p) < len) return false;
+            p += len;
+            break;
+        case 5: /* 32-bit */
+            if (end - p < 4) return false;
+            p += 4;
+            break;
+        default:
+            return false;
+    }
+
+    *pp = p;
+    return true;
+}
+
+/* byte count of a static bytes field, as checked by pb_enc_bytes() */
+#define FASTPB_BYTES_MAX(field) (sizeof(field) - offsetof(pb_bytes_array_t, bytes))
+
+/* ---------- wifi_IPAddr ---------- */
+#define wifi_IPAddr_FASTPB_SUBMSGS (0)
+
+static size_t wifi_IPAddr_fast_measure(const wifi_IPAddr* msg, size_t** sizes) {
+    size_t size = 0;
+    (void)sizes;
+    size += 1 + fastpb_varint_size(sizeof(msg->ipv4)) + sizeof(msg->ipv4);
+    size += 1 + fastpb_varint_size(sizeof(msg->ipv6)) + sizeof(msg->ipv6);
+    return size;
+}
+
+size_t wifi_IPAddr_fast_size(const wifi_IPAddr* msg) {
+    size_t sizes[wifi_IPAddr_FASTPB_SUBMSGS + 1];
+    size_t* next = sizes;
+    return wifi_IPAddr_fast_measure(msg, &next);
+}
+
+static pb_byte_t* wifi_IPAddr_fast_write(const wifi_IPAddr* msg, pb_byte_t* p, const size_t** sizes) {
+    static const pb_byte_t wifi_IPAddr_ipv4_fasttag[] = {0x0a};
+    static const pb_byte_t wifi_IPAddr_ipv6_fasttag[] = {0x12};
+    (void)sizes;
+    p = fastpb_put_tag(p, wifi_IPAddr_ipv4_fasttag, 1);
+    p = fastpb_put_varint(p, sizeof(msg->ipv4));
+    memcpy(p, msg->ipv4, sizeof(msg->ipv4));
+    p += sizeof(msg->ipv4);
+    p = fastpb_put_tag(p, wifi_IPAddr_ipv6_fasttag, 1);
+    p = fastpb_put_varint(p, sizeof(msg->ipv6));
+    memcpy(p, msg->ipv6, sizeof(msg->ipv6));
+    p += sizeof(msg->ipv6);
+    return p;
+}
+
+static bool wifi_IPAddr_fast_read(wifi_IPAddr* msg, const pb_byte_t* p, const pb_byte_t* end) {
+    while (p < end) {
+        uint32_t tag;
+        uint32_t len;
+        if (!fastpb_get_varint32(&p, end, &tag)) return false;
+        switch (tag) {
+            case (1u << 3) | 2:
+                if (!fastpb_get_varint32(&p, end, &len)) return false;
+                if (len == 0) {
+                    memset(msg->ipv4, 0, sizeof(msg->ipv4)); /* empty means all zeros, like pb_decode */
+                    break;
+                }
+                if (len != sizeof(msg->ipv4) || (size_t)(end - p) < len) return false;
+                memcpy(msg->ipv4, p, len);
+                p += len;
+                break;
+            case (2u << 3) | 2:
+                if (!fastpb_get_varint32(&p, end, &len)) return false;
+                if (len == 0) {
+                    memset(msg->ipv6, 0, sizeof(msg->ipv6)); /* empty means all zeros, like pb_decode */
+                    break;
+                }
+                if (len != sizeof(msg->ipv6) || (size_t)(end - p) < len) return false;
+                memcpy(msg->ipv6, p, len);
+                p += len;
+                break;
+            default:
+                if (tag >> 3 == 0) return false; /* zero tag */
+                if ((tag >> 3) == 1u || (tag >> 3) == 2u) return false; /* wrong wire type */
+                if (!fastpb_skip(&p, end, tag & 7)) return false;
+                break;
+        }
+    }
+    return true;
+}
+
+bool wifi_IPAddr_fast_encode(const wifi_IPAddr* msg, pb_byte_t* buf, size_t bufsize, size_t* written) {
+    size_t sizes[wifi_IPAddr_FASTPB_SUBMSGS + 1];
+    size_t* next = sizes;
+    const size_t* cached = sizes;
+    size_t size = wifi_IPAddr_fast_measure(msg, &next);
+    if (size == SIZE_MAX || size > bufsize) return false;
+    wifi_IPAddr_fast_write(msg, buf, &cached);
+    if (written) *written = size;
+    return true;
+}
+
+bool wifi_IPAddr_fast_decode(wifi_IPAddr* msg, const pb_byte_t* buf, size_t size) {
+    memset(msg, 0, sizeof(*msg));
+    return wifi_IPAddr_fast_read(msg, buf, buf + size);
+}
+
+/* ---------- wifi_WifiSoftAPInfo ---------- */
+#define wifi_WifiSoftAPInfo_FASTPB_SUBMSGS (1 + wifi_IPAddr_FASTPB_SUBMSGS)
+
+static size_t wifi_WifiSoftAPInfo_fast_measure(const wifi_WifiSoftAPInfo* msg, size_t** sizes) {
+    size_t size = 0;
+    if (msg->device_count) size += 1 + fastpb_varint_size((uint64_t)(int64_t)msg->device_count);
+    if (msg->state) size += 1 + fastpb_varint_size((uint64_t)(int64_t)msg->state);
+    if (msg->has_ip_address) {
+        size_t* slot = (*sizes)++;
+        size_t sub = wifi_IPAddr_fast_measure(&msg->ip_address, sizes);
+        if (sub == SIZE_MAX) return SIZE_MAX;
+        *slot = sub;
+        size += 1 + fastpb_varint_size(sub) + sub;
+    }
+    if (msg->ssid.size > FASTPB_BYTES_MAX(msg->ssid)) return SIZE_MAX;
+    if (msg->ssid.size) size += 1 + fastpb_varint_size(msg->ssid.size) + msg->ssid.size;
+    size += 1 + fastpb_varint_size(sizeof(msg->bssid)) + sizeof(msg->bssid);
+    if (msg->security) size += 1 + fastpb_varint_size((uint64_t)(int64_t)msg->security);
+    if (msg->channel) size += 1 + fastpb_varint_size((uint64_t)msg->channel);
+    if (msg->frequency) size += 1 + fastpb_varint_size((uint64_t)msg->frequency);
+    return size;
+}
+
+size_t wifi_WifiSoftAPInfo_fast_size(const wifi_WifiSoftAPInfo* msg) {
+    size_t sizes[wifi_WifiSoftAPInfo_FASTPB_SUBMSGS + 1];
+    size_t* next = sizes;
+    return wifi_WifiSoftAPInfo_fast_measure(msg, &next);
+}
+
+static pb_byte_t* wifi_WifiSoftAPInfo_fast_write(const wifi_WifiSoftAPInfo* msg, pb_byte_t* p, const size_t** sizes) {
+    static const pb_byte_t wifi_WifiSoftAPInfo_device_count_fasttag[] = {0x08};
+    static const pb_byte_t wifi_WifiSoftAPInfo_state_fasttag[] = {0x10};
+    static const pb_byte_t wifi_WifiSoftAPInfo_ip_address_fasttag[] = {0x1a};
+    static const pb_byte_t wifi_WifiSoftAPInfo_ssid_fasttag[] = {0x22};
+    static const pb_byte_t wifi_WifiSoftAPInfo_bssid_fasttag[] = {0x2a};
+    static const pb_byte_t wifi_WifiSoftAPInfo_security_fasttag[] = {0x30};
+    static const pb_byte_t wifi_WifiSoftAPInfo_channel_fasttag[] = {0x38};
+    static const pb_byte_t wifi_WifiSoftAPInfo_frequency_fasttag[] = {0x40};
+    if (msg->device_count) {
+        p = fastpb_put_tag(p, wifi_WifiSoftAPInfo_device_count_fasttag, 1);
+        p = fastpb_put_varint(p, (uint64_t)(int64_t)msg->device_count);
+    }
+    if (msg->state) {
+        p = fastpb_put_tag(p, wifi_WifiSoftAPInfo_state_fasttag, 1);
+        p = fastpb_put_varint(p, (uint64_t)(int64_t)msg->state);
+    }
+    if (msg->has_ip_address) {
+        p = fastpb_put_tag(p, wifi_WifiSoftAPInfo_ip_address_fasttag, 1);
+        p = fastpb_put_varint(p, *(*sizes)++);
+        p = wifi_IPAddr_fast_write(&msg->ip_address, p, sizes);
+    }
+    if (msg->ssid.size) {
+        p = fastpb_put_tag(p, wifi_WifiSoftAPInfo_ssid_fasttag, 1);
+        p = fastpb_put_varint(p, msg->ssid.size);
+        memcpy(p, msg->ssid.bytes, msg->ssid.size);
+        p += msg->ssid.size;
+    }
+    p = fastpb_put_tag(p, wifi_WifiSoftAPInfo_bssid_fasttag, 1);
+    p = fastpb_put_varint(p, sizeof(msg->bssid));
+    memcpy(p, msg->bssid, sizeof(msg->bssid));
+    p += sizeof(msg->bssid);
+    if (msg->security) {
+        p = fastpb_put_tag(p, wifi_WifiSoftAPInfo_security_fasttag, 1);
+        p = fastpb_put_varint(p, (uint64_t)(int64_t)msg->security);
+    }
+    if (msg->channel) {
+        p = fastpb_put_tag(p, wifi_WifiSoftAPInfo_channel_fasttag, 1);
+        p = fastpb_put_varint(p, (uint64_t)msg->channel);
+    }
+    if (msg->frequency) {
+        p = fastpb_put_tag(p, wifi_WifiSoftAPInfo_frequency_fasttag, 1);
+        p = fastpb_put_varint(p, (uint64_t)msg->frequency);
+    }
+    return p;
+}
+
+static bool wifi_WifiSoftAPInfo_fast_read(wifi_WifiSoftAPInfo* msg, const pb_byte_t* p, const pb_byte_t* end) {
+    while (p < end) {
+        uint32_t tag;
+        uint32_t len;
+        uint64_t value;
+        if (!fastpb_get_varint32(&p, end, &tag)) return false;
+        switch (tag) {
+            case (1u << 3) | 0:
+                if (!fastpb_get_varint(&p, end, &value)) return false;
+                msg->device_count = (int32_t)value;
+                break;
+            case (2u << 3) | 0:
+                if (!fastpb_get_varint(&p, end, &value)) return false;
+                msg->state = (int32_t)value;
+                break;
+            case (3u << 3) | 2:
+                if (!fastpb_get_varint32(&p, end, &len)) return false;
+                if ((size_t)(end - p) < len) return false;
+                msg->has_ip_address = true; /* merged like pb_decode, not reset */
+                if (!wifi_IPAddr_fast_read(&msg->ip_address, p, p + len)) return false;
+                p += len;
+                break;
+            case (4u << 3) | 2:
+                if (!fastpb_get_varint32(&p, end, &len)) return false;
+                if (len > PB_SIZE_MAX || PB_BYTES_ARRAY_T_ALLOCSIZE(len) > sizeof(msg->ssid)) return false;
+                if ((size_t)(end - p) < len) return false;
+                msg->ssid.size = (pb_size_t)len;
+                memcpy(msg->ssid.bytes, p, len);
+                p += len;
+                break;
+            case (5u << 3) | 2:
+                if (!fastpb_get_varint32(&p, end, &len)) return false;
+                if (len == 0) {
+                    memset(msg->bssid, 0, sizeof(msg->bssid)); /* empty means all zeros, like pb_decode */
+                    break;
+                }
+                if (len != sizeof(msg->bssid) || (size_t)(end - p) < len) return false;
+                memcpy(msg->bssid, p, len);
+                p += len;
+                break;
+            case (6u << 3) | 0:
+                if (!fastpb_get_varint(&p, end, &value)) return false;
+                msg->security = (int32_t)value;
+                break;
+            case (7u << 3) | 0:
+                if (!fastpb_get_varint(&p, end, &value)) return false;
+                if (value > UINT32_MAX) return false;
+                msg->channel = (uint32_t)value;
+                break;
+            case (8u << 3) | 0:
+                if (!fastpb_get_varint(&p, end, &value)) return false;
+                if (value > UINT32_MAX) return false;
+                msg->frequency = (uint32_t)value;
+                break;
+            default:
+                if (tag >> 3 == 0) return false; /* zero tag */
+                if ((tag >> 3) == 1u || (tag >> 3) == 2u || (tag >> 3) == 3u || (tag >> 3) == 4u || (tag >> 3) == 5u || (tag >> 3) == 6u || (tag >> 3) == 7u || (tag >> 3) == 8u) return false; /* wrong wire type */
+                if (!fastpb_skip(&p, end, tag & 7)) return false;
+                break;
+        }
+    }
+    return true;
+}
+
+bool wifi_WifiSoftAPInfo_fast_encode(const wifi_WifiSoftAPInfo* msg, pb_byte_t* buf, size_t bufsize, size_t* written) {
+    size_t sizes[wifi_WifiSoftAPInfo_FASTPB_SUBMSGS + 1];
+    size_t* next = sizes;
+    const size_t* cached = sizes;
+    size_t size = wifi_WifiSoftAPInfo_fast_measure(msg, &next);
+    if (size == SIZE_MAX || size > bufsize) return false;
+    wifi_WifiSoftAPInfo_fast_write(msg, buf, &cached);
+    if (written) *written = size;
+    return true;
+}
+
+bool wifi_WifiSoftAPInfo_fast_decode(wifi_WifiSoftAPInfo* msg, const pb_byte_t* buf, size_t size) {
+    memset(msg, 0, sizeof(*msg));
+    return wifi_WifiSoftAPInfo_fast_read(msg, buf, buf + size);
+}
+
+/* ---------- wifi_WifiSoftAPList ---------- */
+#define wifi_WifiSoftAPList_FASTPB_SUBMSGS (pb_arraysize(wifi_WifiSoftAPList, ap_list) * (1 + wifi_WifiSoftAPInfo_FASTPB_SUBMSGS))
+
+static size_t wifi_WifiSoftAPList_fast_measure(const wifi_WifiSoftAPList* msg, size_t** sizes) {
+    size_t size = 0;
+    if (msg->ap_list_count > pb_arraysize(wifi_WifiSoftAPList, ap_list)) return SIZE_MAX;
+    for (pb_size_t i = 0; i < msg->ap_list_count; i++) {
+        size_t* slot = (*sizes)++;
+        size_t sub = wifi_WifiSoftAPInfo_fast_measure(&msg->ap_list[i], sizes);
+        if (sub == SIZE_MAX) return SIZE_MAX;
+        *slot = sub;
+        size += 1 + fastpb_varint_size(sub) + sub;
+    }
+    return size;
+}
+
+size_t wifi_WifiSoftAPList_fast_size(const wifi_WifiSoftAPList* msg) {
+    size_t sizes[wifi_WifiSoftAPList_FASTPB_SUBMSGS + 1];
+    size_t* next = sizes;
+    return wifi_WifiSoftAPList_fast_measure(msg, &next);
+}
+
+static pb_byte_t* wifi_WifiSoftAPList_fast_write(const wifi_WifiSoftAPList* msg, pb_byte_t* p, const size_t** sizes) {
+    static const pb_byte_t wifi_WifiSoftAPList_ap_list_fasttag[] = {0x0a};
+    for (pb_size_t i = 0; i < msg->ap_list_count; i++) {
+        p = fastpb_put_tag(p, wifi_WifiSoftAPList_ap_list_fasttag, 1);
+        p = fastpb_put_varint(p, *(*sizes)++);
+        p = wifi_WifiSoftAPInfo_fast_write(&msg->ap_list[i], p, sizes);
+    }
+    return p;
+}
+
+static bool wifi_WifiSoftAPList_fast_read(wifi_WifiSoftAPList* msg, const pb_byte_t* p, const pb_byte_t* end) {
+    while (p < end) {
+        uint32_t tag;
+        uint32_t len;
+        if (!fastpb_get_varint32(&p, end, &tag)) return false;
+        switch (tag) {
+            case (1u << 3) | 2:
+                if (!fastpb_get_varint32(&p, end, &len)) return false;
+                if ((size_t)(end - p) < len) return false;
+                if (msg->ap_list_count >= pb_arraysize(wifi_WifiSoftAPList, ap_list)) return false;
+                memset(&msg->ap_list[msg->ap_list_count], 0, sizeof(msg->ap_list[0]));
+                if (!wifi_WifiSoftAPInfo_fast_read(&msg->ap_list[msg->ap_list_count++], p, p + len)) return false;
+                p += len;
+                break;
+            default:
+                if (tag >> 3 == 0) return false; /* zero tag */
+                if ((tag >> 3) == 1u) return false; /* wrong wire type */
+                if (!fastpb_skip(&p, end, tag & 7)) return false;
+                break;
+        }
+    }
+    return true;
+}
+
+bool wifi_WifiSoftAPList_fast_encode(const wifi_WifiSoftAPList* msg, pb_byte_t* buf, size_t bufsize, size_t* written) {
+    size_t sizes[wifi_WifiSoftAPList_FASTPB_SUBMSGS + 1];
+    size_t* next = sizes;
+    const size_t* cached = sizes;
+    size_t size = wifi_WifiSoftAPList_fast_measure(msg, &next);
+    if (size == SIZE_MAX || size > bufsize) return false;
+    wifi_WifiSoftAPList_fast_write(msg, buf, &cached);
+    if (written) *written = size;
+    return true;
+}
+
+bool wifi_WifiSoftAPList_fast_decode(wifi_WifiSoftAPList* msg, const pb_byte_t* buf, size_t size) {
+    memset(msg, 0, sizeof(*msg));
+    return wifi_WifiSoftAPList_fast_read(msg, buf, buf + size);
+}
@@ -0,0 +1,30 @@
+/* Automatically generated by fastpb_generator.py from sample_structure.proto */
+/* Straight-line encoders/decoders, wire-compatible with pb_encode/pb_decode */
+
+#ifndef PB_WIFI_SAMPLE_STRUCTURE_FASTPB_H_INCLUDED
+#define PB_WIFI_SAMPLE_STRUCTURE_FASTPB_H_INCLUDED
+#include <stdbool.h>
+#include <stddef.h>
+#include "sample_structure.pb.h"
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+size_t wifi_IPAddr_fast_size(const wifi_IPAddr* msg);
+bool wifi_IPAddr_fast_encode(const wifi_IPAddr* msg, pb_byte_t* buf, size_t bufsize, size_t* written);
+bool wifi_IPAddr_fast_decode(wifi_IPAddr* msg, const pb_byte_t* buf, size_t size);
+
+size_t wifi_WifiSoftAPInfo_fast_size(const wifi_WifiSoftAPInfo* msg);
+bool wifi_WifiSoftAPInfo_fast_encode(const wifi_WifiSoftAPInfo* msg, pb_byte_t* buf, size_t bufsize, size_t* written);
+bool wifi_WifiSoftAPInfo_fast_decode(wifi_WifiSoftAPInfo* msg, const pb_byte_t* buf, size_t size);
+
+size_t wifi_WifiSoftAPList_fast_size(const wifi_WifiSoftAPList* msg);
+bool wifi_WifiSoftAPList_fast_encode(const wifi_WifiSoftAPList* msg, pb_byte_t* buf, size_t bufsize, size_t* written);
+bool wifi_WifiSoftAPList_fast_decode(wifi_WifiSoftAPList* msg, const pb_byte_t* buf, size_t size);
+
+#ifdef __cplusplus
+} /* extern "C" */
+#endif
+
+#endif
@@ -10,16 +10,13 @@
 #endif
 
 /* Struct definitions */
-typedef PB_BYTES_ARRAY_T(4) wifi_IPAddr_ipv4_t;
-typedef PB_BYTES_ARRAY_T(16) wifi_IPAddr_ipv6_t;
 /* IP address */
 typedef struct _wifi_IPAddr {
-    wifi_IPAddr_ipv4_t ipv4; /* 4 bytes */
-    wifi_IPAddr_ipv6_t ipv6; /* 16 bytes */
+    pb_byte_t ipv4[4]; /* 4 bytes */
+    pb_byte_t ipv6[16]; /* 16 bytes */
 } wifi_IPAddr;
 
 typedef PB_BYTES_ARRAY_T(33) wifi_WifiSoftAPInfo_ssid_t;
-typedef PB_BYTES_ARRAY_T(6) wifi_WifiSoftAPInfo_bssid_t;
 /* WiFi SoftAP info */
 typedef struct _wifi_WifiSoftAPInfo {
     int32_t device_count;
@@ -27,7 +24,7 @@ typedef struct _wifi_WifiSoftAPInfo {
     bool has_ip_address;
     wifi_IPAddr ip_address;
     wifi_WifiSoftAPInfo_ssid_t ssid;
-    wifi_WifiSoftAPInfo_bssid_t bssid;
+    pb_byte_t bssid[6];
     int32_t security;
     uint32_t channel;
     uint32_t frequency;
@@ -44,11 +41,11 @@ extern "C" {
 #endif
 
 /* Initializer values for message structs */
-#define wifi_IPAddr_init_default                 {{0, {0}}, {0, {0}}}
-#define wifi_WifiSoftAPInfo_init_default         {0, 0, false, wifi_IPAddr_init_default, {0, {0}}, {0, {0}}, 0, 0, 0}
+#define wifi_IPAddr_init_default                 {{0}, {0}}
+#define wifi_WifiSoftAPInfo_init_default         {0, 0, false, wifi_IPAddr_init_default, {0, {0}}, {0}, 0, 0, 0}
 #define wifi_WifiSoftAPList_init_default         {0, {wifi_WifiSoftAPInfo_init_default, wifi_WifiSoftAPInfo_init_default, wifi_WifiSoftAPInfo_init_default, wifi_WifiSoftAPInfo_init_default, wifi_WifiSoftAPInfo_init_default, wifi_WifiSoftAPInfo_init_default, wifi_WifiSoftAPInfo_init_default, wifi_WifiSoftAPInfo_init_default, wifi_WifiSoftAPInfo_init_default, wifi_WifiSoftAPInfo_init_default, wifi_WifiSoftAPInfo_init_default, wifi_WifiSoftAPInfo_init_default, wifi_WifiSoftAPInfo_init_default, wifi_WifiSoftAPInfo_init_default, wifi_WifiSoftAPInfo_init_default, wifi_WifiSoftAPInfo_init_default, wifi_WifiSoftAPInfo_init_default, wifi_WifiSoftAPInfo_init_default, wifi_WifiSoftAPInfo_init_default, wifi_WifiSoftAPInfo_init_default}}
-#define wifi_IPAddr_init_zero                    {{0, {0}}, {0, {0}}}
-#define wifi_WifiSoftAPInfo_init_zero            {0, 0, false, wifi_IPAddr_init_zero, {0, {0}}, {0, {0}}, 0, 0, 0}
+#define wifi_IPAddr_init_zero                    {{0}, {0}}
+#define wifi_WifiSoftAPInfo_init_zero            {0, 0, false, wifi_IPAddr_init_zero, {0, {0}}, {0}, 0, 0, 0}
 #define wifi_WifiSoftAPList_init_zero            {0, {wifi_WifiSoftAPInfo_init_zero, wifi_WifiSoftAPInfo_init_zero, wifi_WifiSoftAPInfo_init_zero, wifi_WifiSoftAPInfo_init_zero, wifi_WifiSoftAPInfo_init_zero, wifi_WifiSoftAPInfo_init_zero, wifi_WifiSoftAPInfo_init_zero, wifi_WifiSoftAPInfo_init_zero, wifi_WifiSoftAPInfo_init_zero, wifi_WifiSoftAPInfo_init_zero, wifi_WifiSoftAPInfo_init_zero, wifi_WifiSoftAPInfo_init_zero, wifi_WifiSoftAPInfo_init_zero, wifi_WifiSoftAPInfo_init_zero, wifi_WifiSoftAPInfo_init_zero, wifi_WifiSoftAPInfo_init_zero, wifi_WifiSoftAPInfo_init_zero, wifi_WifiSoftAPInfo_init_zero, wifi_WifiSoftAPInfo_init_zero, wifi_WifiSoftAPInfo_init_zero}}
 
 /* Field tags (for use in manual encoding/decoding) */
@@ -66,8 +63,8 @@ extern "C" {
 
 /* Struct field encoding specification for nanopb */
 #define wifi_IPAddr_FIELDLIST(X, a) \
-X(a, STATIC,   SINGULAR, BYTES,    ipv4,              1) \
-X(a, STATIC,   SINGULAR, BYTES,    ipv6,              2)
+X(a, STATIC,   SINGULAR, FIXED_LENGTH_BYTES, ipv4,              1) \
+X(a, STATIC,   SINGULAR, FIXED_LENGTH_BYTES, ipv6,              2)
 #define wifi_IPAddr_CALLBACK NULL
 #define wifi_IPAddr_DEFAULT NULL
 
@@ -76,7 +73,7 @@ X(a, STATIC,   SINGULAR, INT32,    device_count,      1) \
 X(a, STATIC,   SINGULAR, INT32,    state,             2) \
 X(a, STATIC,   OPTIONAL, MESSAGE,  ip_address,        3) \
 X(a, STATIC,   SINGULAR, BYTES,    ssid,              4) \
-X(a, STATIC,   SINGULAR, BYTES,    bssid,             5) \
+X(a, STATIC,   SINGULAR, FIXED_LENGTH_BYTES, bssid,             5) \
 X(a, STATIC,   SINGULAR, INT32,    security,          6) \
 X(a, STATIC,   SINGULAR, UINT32,   channel,           7) \
 X(a, STATIC,   SINGULAR, UINT32,   frequency,         8)
@@ -4,6 +4,7 @@
 #include "../sample_structure.h" /* defines wifi_softap_info_t, constants */
 #include "nanopb/pb_decode.h"
 #include "nanopb/pb_encode.h"
+#include "nanopb/sample_structure.fastpb.h"
 #include "nanopb/sample_structure.pb.h"
 
 /*
@@ -19,12 +20,9 @@ int parse_wifi_softap_info(const wifi_softap_info_t* info, wifi_WifiSoftAPInfo*
     message->state = info->state;
     message->has_ip_address = true;
 
-    /* ip bytes: the generated types use .size and .bytes members */
-    memcpy(message->ip_address.ipv4.bytes, info->ip_address.ipv4, sizeof(info->ip_address.ipv4));
-    message->ip_address.ipv4.size = sizeof(info->ip_address.ipv4);
-
-    memcpy(message->ip_address.ipv6.bytes, info->ip_address.ipv6, sizeof(info->ip_address.ipv6));
-    message->ip_address.ipv6.size = sizeof(info->ip_address.ipv6);
+    /* ipv4 / ipv6 / bssid are fixed_length: plain arrays of the same size as ours */
+    memcpy(message->ip_address.ipv4, info->ip_address.ipv4, sizeof(info->ip_address.ipv4));
+    memcpy(message->ip_address.ipv6, info->ip_address.ipv6, sizeof(info->ip_address.ipv6));
 
     /* ssid: store length and bytes (ssid PB array length likely 33) */
     size_t ssid_len = strnlen(info->ssid, WIFI_SSID_MAX_LEN);
@@ -34,8 +32,7 @@ int parse_wifi_softap_info(const wifi_softap_info_t* info, wifi_WifiSoftAPInfo*
     memcpy(message->ssid.bytes, info->ssid, ssid_len);
     message->ssid.size = (pb_size_t)ssid_len;
 
-    memcpy(message->bssid.bytes, info->bssid, sizeof(info->bssid));
-    message->bssid.size = sizeof(info->bssid);
+    memcpy(message->bssid, info->bssid, sizeof(info->bssid));
 
     message->security = info->security;
     message->channel = info->channel;
@@ -57,13 +54,8 @@ int parse_wifi_WifiSoftAPInfo(wifi_WifiSoftAPInfo* message, wifi_softap_info_t*
     info->state = message->state;
 
     if (message->has_ip_address) {
-        size_t ipv4_size = (size_t)message->ip_address.ipv4.size;
-        if (ipv4_size > sizeof(info->ip_address.ipv4)) ipv4_size = sizeof(info->ip_address.ipv4);
-        memcpy(info->ip_address.ipv4, message->ip_address.ipv4.bytes, ipv4_size);
-
-        size_t ipv6_size = (size_t)message->ip_address.ipv6.size;
-        if (ipv6_size > sizeof(info->ip_address.ipv6)) ipv6_size = sizeof(info->ip_address.ipv6);
-        memcpy(info->ip_address.ipv6, message->ip_address.ipv6.bytes, ipv6_size);
+        memcpy(info->ip_address.ipv4, message->ip_address.ipv4, sizeof(info->ip_address.ipv4));
+        memcpy(info->ip_address.ipv6, message->ip_address.ipv6, sizeof(info->ip_address.ipv6));
     }
 
     size_t sslen = (size_t)message->ssid.size;
@@ -71,7 +63,7 @@ int parse_wifi_WifiSoftAPInfo(wifi_WifiSoftAPInfo* message, wifi_softap_info_t*
     memcpy(info->ssid, message->ssid.bytes, sslen);
     info->ssid[sslen] = '\0';
 
-    memcpy(info->bssid, message->bssid.bytes, sizeof(info->bssid));
+    memcpy(info->bssid, message->bssid, sizeof(info->bssid));
 
     info->security = message->security;
     info->channel = (uint8_t)message->channel;
@@ -187,4 +179,876 @@ int nanopb_decode_array(void* buf, size_t size, wifi_softap_info_t* out_infos, i
 
     return 0;
 }
+
+/*
+ * nanopb_decode_ap_list
+ *  - input: *buf, size, entry / ctx decoding one ap_list submessage
+ *  - output: *out_count entries passed to entry() with their index
+ *  - return: 0 on success, -1 on failure
+ * Walks a WifiSoftAPList one ap_list entry at a time with the rules of
+ * pb_decode: unknown fields are skipped; a zero tag, a wrong wire type or
+ * more than MAX_ARRAY entries is an error. Used by the decoders that don't
+ * go through a wifi_WifiSoftAPList struct.
+ */
+typedef bool (*nanopb_ap_entry_t)(pb_istream_t* substream, int index, void* ctx);
+
+int nanopb_decode_ap_list(void* buf, size_t size, nanopb_ap_entry_t entry, void* ctx, int* out_count) {
+    pb_istream_t stream = pb_istream_from_buffer((const pb_byte_t*)buf, size);
+    const char* error = NULL;
+    int count = 0;
+
+    while (stream.bytes_left) {
+        pb_istream_t substream;
+        pb_wire_type_t wire_type;
+        uint32_t tag;
+        bool eof;
+
+        if (!pb_decode_tag(&stream, &wire_type, &tag, &eof)) goto fail;
+        if (tag == 0) {
+            error = "zero tag";
+            goto fail;
+        }
+        if (tag != wifi_WifiSoftAPList_ap_list_tag) {
+            if (!pb_skip_field(&stream, wire_type)) goto fail;
+            continue;
+        }
+        if (wire_type != PB_WT_STRING) {
+            error = "wrong wire type";
+            goto fail;
+        }
+        if (count >= MAX_ARRAY) {
+            error = "array overflow";
+            goto fail;
+        }
+
+        if (!pb_make_string_substream(&stream, &substream)) goto fail;
+        bool status = entry(&substream, count, ctx);
+        if (!pb_close_string_substream(&stream, &substream) || !status) goto fail;
+        count++;
+    }
+
+    *out_count = count;
+    return 0;
+
+fail:
+    fprintf(stderr, "Nanopb decode failed: %s\n", error ? error : PB_GET_ERROR(&stream));
+    return -1;
+}
+
+/* ---------- nanopb_reuse: caller-owned decode messages ---------- */
+/*
+ * nanopb_decode() builds a fresh wifi_WifiSoftAPInfo_init_default and
+ * pb_decode() then walks every field again to set it to its default;
+ * nanopb_decode_array() zero-inits the whole 20 entry list on the stack.
+ * A nanopb_decoder_t keeps one message across calls instead: decode runs
+ * with PB_DECODE_NOINIT, and only what a previous decode can have set is put
+ * back to default first (nanopb_reset_WifiSoftAPInfo). Keep one per thread,
+ * e.g. static, and zero it once (static storage or nanopb_decoder_init).
+ */
+typedef struct {
+    wifi_WifiSoftAPInfo info;
+} nanopb_decoder_t;
+
+void nanopb_decoder_init(nanopb_decoder_t* decoder) {
+    memset(decoder, 0, sizeof(*decoder));
+}
+
+/*
+ * Targeted reset between NOINIT decodes. Invariant: ip_address is all zeros
+ * while has_ip_address is false, so it is only cleared after it was decoded.
+ * ssid bytes past ssid.size are never read and are left as they are.
+ */
+static inline void nanopb_reset_WifiSoftAPInfo(wifi_WifiSoftAPInfo* message) {
+    message->device_count = 0;
+    message->state = 0;
+    if (message->has_ip_address) {
+        memset(&message->ip_address, 0, sizeof(message->ip_address));
+        message->has_ip_address = false;
+    }
+    message->ssid.size = 0;
+    memset(message->bssid, 0, sizeof(message->bssid));
+    message->security = 0;
+    message->channel = 0;
+    message->frequency = 0;
+}
+
+/*
+ * nanopb_decode_into
+ *  - input: nanopb_decoder_t *decoder, *buffer, size
+ *  - output: wifi_softap_info_t *out_info
+ *  - return: 0 on success, -1 on failure
+ */
+int nanopb_decode_into(nanopb_decoder_t* decoder, void* buffer, size_t size, wifi_softap_info_t* out_info) {
+    if (!decoder || !buffer || size == 0 || !out_info) return -1;
+
+    wifi_WifiSoftAPInfo* message = &decoder->info;
+    nanopb_reset_WifiSoftAPInfo(message);
+
+    pb_istream_t stream = pb_istream_from_buffer((const pb_byte_t*)buffer, size);
+    if (!pb_decode_noinit(&stream, wifi_WifiSoftAPInfo_fields, message)) {
+        fprintf(stderr, "Nanopb decode failed: %s\n", PB_GET_ERROR(&stream));
+        return -1;
+    }
+
+    parse_wifi_WifiSoftAPInfo(message, out_info);
+    return 0;
+}
+
+typedef struct {
+    nanopb_decoder_t* decoder;
+    wifi_softap_info_t* out_infos;
+} nanopb_reuse_list_t;
+
+bool nanopb_reuse_decode_ap(pb_istream_t* substream, int index, void* ctx) {
+    nanopb_reuse_list_t* list = (nanopb_reuse_list_t*)ctx;
+    wifi_WifiSoftAPInfo* message = &list->decoder->info;
+
+    nanopb_reset_WifiSoftAPInfo(message);
+    if (!pb_decode_noinit(substream, wifi_WifiSoftAPInfo_fields, message)) return false;
+    parse_wifi_WifiSoftAPInfo(message, &list->out_infos[index]);
+    return true;
+}
+
+/*
+ * nanopb_decode_array_into
+ *  - input: nanopb_decoder_t *decoder, *buf, size
+ *  - output: wifi_softap_info_t *out_infos, *out_count
+ *  - return: 0 on success, -1 on failure
+ * Decoded as WifiSoftAPList, but ap_list entries are read one at a time into
+ * decoder->info with the same reset + NOINIT decode, so no list struct is
+ * initialized (pb_decode would set every repeated entry to defaults).
+ */
+int nanopb_decode_array_into(nanopb_decoder_t* decoder, void* buf, size_t size, wifi_softap_info_t* out_infos, int* out_count) {
+    if (!decoder || !buf || size == 0 || !out_infos || !out_count) return -1;
+
+    nanopb_reuse_list_t list = {decoder, out_infos};
+    return nanopb_decode_ap_list(buf, size, nanopb_reuse_decode_ap, &list, out_count);
+}
+
+/* nanopb_reuse in the demo: the decoder shared by all calls */
+static nanopb_decoder_t nanopb_reuse_decoder;
+
+int nanopb_reuse_decode(void* buffer, size_t size, wifi_softap_info_t* out_info) {
+    return nanopb_decode_into(&nanopb_reuse_decoder, buffer, size, out_info);
+}
+
+int nanopb_reuse_decode_array(void* buf, size_t size, wifi_softap_info_t* out_infos, int* out_count) {
+    return nanopb_decode_array_into(&nanopb_reuse_decoder, buf, size, out_infos, out_count);
+}
+
+/* ---------- nanopb_view: bytes fields as views into the input ---------- */
+/*
+ * pb_dec_bytes copies ipv4 / ipv6 / ssid / bssid into the message and
+ * parse_wifi_WifiSoftAPInfo copies them again. wifi_view_* describe the same
+ * messages with those four fields as CALLBACK bytes: the callback only
+ * records where the value is in the input buffer (nanopb_bytes_view_t), so
+ * the caller copies once (nanopb_view_copy) or reads the views directly.
+ * Views point into the decoded buffer and are valid as long as it is.
+ * The length limits of the schema path are kept: ssid at most what fits
+ * wifi_WifiSoftAPInfo_ssid_t (pb_dec_bytes checks the padded struct size),
+ * ipv4 / ipv6 / bssid empty or exactly 4 / 16 / 6 bytes.
+ */
+#define NANOPB_VIEW_SSID_MAX (sizeof(wifi_WifiSoftAPInfo_ssid_t) - offsetof(pb_bytes_array_t, bytes))
+
+typedef struct {
+    const pb_byte_t* bytes; /* NULL when absent or empty */
+    pb_size_t size;
+} nanopb_bytes_view_t;
+
+typedef struct {
+    pb_callback_t ipv4;
+    pb_callback_t ipv6;
+} wifi_view_IPAddr;
+
+typedef struct {
+    int32_t device_count;
+    int32_t state;
+    bool has_ip_address;
+    wifi_view_IPAddr ip_address;
+    pb_callback_t ssid;
+    pb_callback_t bssid;
+    int32_t security;
+    uint32_t channel;
+    uint32_t frequency;
+} wifi_view_WifiSoftAPInfo;
+
+/*
+ * The field lists are the generated ones with every BYTES /
+ * FIXED_LENGTH_BYTES field turned into CALLBACK BYTES, so they follow
+ * sample_structure.pb.h. A field type not in the NANOPB_VIEW_* tables
+ * below fails to compile, as does a view struct without the new member.
+ */
+#define NANOPB_VIEW_ATYPE_INT32(atype) atype
+#define NANOPB_VIEW_ATYPE_UINT32(atype) atype
+#define NANOPB_VIEW_ATYPE_MESSAGE(atype) atype
+#define NANOPB_VIEW_ATYPE_BYTES(atype) CALLBACK
+#define NANOPB_VIEW_ATYPE_FIXED_LENGTH_BYTES(atype) CALLBACK
+#define NANOPB_VIEW_LTYPE_INT32 INT32
+#define NANOPB_VIEW_LTYPE_UINT32 UINT32
+#define NANOPB_VIEW_LTYPE_MESSAGE MESSAGE
+#define NANOPB_VIEW_LTYPE_BYTES BYTES
+#define NANOPB_VIEW_LTYPE_FIXED_LENGTH_BYTES BYTES
+
+/* Xa is (X, a): X and its argument, passed through the generated list */
+#define NANOPB_VIEW_UNPACK(X, a) X, a
+#define NANOPB_VIEW_CALL(X, a, atype, htype, ltype, name, tag) X(a, atype, htype, ltype, name, tag)
+#define NANOPB_VIEW_APPLY(...) NANOPB_VIEW_CALL(__VA_ARGS__)
+#define NANOPB_VIEW_FIELD(Xa, atype, htype, ltype, name, tag) \
+    NANOPB_VIEW_APPLY(NANOPB_VIEW_UNPACK Xa, NANOPB_VIEW_ATYPE_##ltype(atype), htype, NANOPB_VIEW_LTYPE_##ltype, name, tag)
+
+#define wifi_view_IPAddr_FIELDLIST(X, a) wifi_IPAddr_FIELDLIST(NANOPB_VIEW_FIELD, (X, a))
+#define wifi_view_IPAddr_CALLBACK pb_default_field_callback
+#define wifi_view_IPAddr_DEFAULT NULL
+
+#define wifi_view_WifiSoftAPInfo_FIELDLIST(X, a) wifi_WifiSoftAPInfo_FIELDLIST(NANOPB_VIEW_FIELD, (X, a))
+#define wifi_view_WifiSoftAPInfo_CALLBACK pb_default_field_callback
+#define wifi_view_WifiSoftAPInfo_DEFAULT NULL
+#define wifi_view_WifiSoftAPInfo_ip_address_MSGTYPE wifi_view_IPAddr
+
+PB_BIND(wifi_view_IPAddr, wifi_view_IPAddr, AUTO)
+PB_BIND(wifi_view_WifiSoftAPInfo, wifi_view_WifiSoftAPInfo, AUTO)
+
+#define wifi_view_IPAddr_fields &wifi_view_IPAddr_msg
+#define wifi_view_WifiSoftAPInfo_fields &wifi_view_WifiSoftAPInfo_msg
+
+typedef struct {
+    wifi_view_WifiSoftAPInfo message; /* scalars are decoded in place */
+    nanopb_bytes_view_t ipv4;
+    nanopb_bytes_view_t ipv6;
+    nanopb_bytes_view_t ssid;
+    nanopb_bytes_view_t bssid;
+} nanopb_softap_view_t;
+
+/*
+ * Callback of all four bytes fields, arg is the nanopb_softap_view_t. Their
+ * tags (ipv4 1, ipv6 2, ssid 4, bssid 5) don't overlap, so the tag selects
+ * the view. pb_decode rejects a scalar wire type for a BYTES callback, so
+ * the substream is always a window of the buffer being decoded.
+ */
+bool nanopb_decode_bytes_view(pb_istream_t* stream, const pb_field_t* field, void** arg) {
+    nanopb_softap_view_t* owner = (nanopb_softap_view_t*)*arg;
+    const pb_byte_t* bytes = (const pb_byte_t*)stream->state;
+    size_t size = stream->bytes_left;
+    nanopb_bytes_view_t* view;
+    size_t fixed_size = 0;
+
+    switch (field->tag) {
+        case wifi_IPAddr_ipv4_tag:
+            view = &owner->ipv4;
+            fixed_size = IPV4_LEN;
+            break;
+        case wifi_IPAddr_ipv6_tag:
+            view = &owner->ipv6;
+            fixed_size = IPV6_LEN;
+            break;
+        case wifi_WifiSoftAPInfo_ssid_tag:
+            view = &owner->ssid;
+            break;
+        case wifi_WifiSoftAPInfo_bssid_tag:
+            view = &owner->bssid;
+            fixed_size = WIFI_BT_MAC_ADDRESS_LEN;
+            break;
+        default:
+            PB_RETURN_ERROR(stream, "invalid field descriptor");
+    }
+
+    if (fixed_size && size != 0 && size != fixed_size) PB_RETURN_ERROR(stream, "incorrect fixed length bytes size");
+    if (!fixed_size && size > NANOPB_VIEW_SSID_MAX) PB_RETURN_ERROR(stream, "bytes overflow");
+
+    view->bytes = size ? bytes : NULL;
+    view->size = (pb_size_t)size;
+    return pb_read(stream, NULL, size);
+}
+
+/* Empty views and callbacks bound to view, before each record */
+static inline void nanopb_view_reset(nanopb_softap_view_t* view) {
+    wifi_view_WifiSoftAPInfo* message = &view->message;
+
+    message->ip_address.ipv4.funcs.decode = nanopb_decode_bytes_view;
+    message->ip_address.ipv4.arg = view;
+    message->ip_address.ipv6.funcs.decode = nanopb_decode_bytes_view;
+    message->ip_address.ipv6.arg = view;
+    message->ssid.funcs.decode = nanopb_decode_bytes_view;
+    message->ssid.arg = view;
+    message->bssid.funcs.decode = nanopb_decode_bytes_view;
+    message->bssid.arg = view;
+
+    view->ipv4 = (nanopb_bytes_view_t){NULL, 0};
+    view->ipv6 = (nanopb_bytes_view_t){NULL, 0};
+    view->ssid = (nanopb_bytes_view_t){NULL, 0};
+    view->bssid = (nanopb_bytes_view_t){NULL, 0};
+}
+
+/*
+ * nanopb_decode_view
+ *  - input: *buffer, size
+ *  - output: nanopb_softap_view_t *view, bytes fields pointing into buffer
+ *  - return: 0 on success, -1 on failure
+ */
+int nanopb_decode_view(const void* buffer, size_t size, nanopb_softap_view_t* view) {
+    if (!buffer || size == 0 || !view) return -1;
+
+    nanopb_view_reset(view);
+
+    pb_istream_t stream = pb_istream_from_buffer((const pb_byte_t*)buffer, size);
+    if (!pb_decode(&stream, wifi_view_WifiSoftAPInfo_fields, &view->message)) {
+        fprintf(stderr, "Nanopb decode failed: %s\n", PB_GET_ERROR(&stream));
+        return -1;
+    }
+    return 0;
+}
+
+/*
+ * nanopb_view_copy
+ *  - input: nanopb_softap_view_t *view
+ *  - output: wifi_softap_info_t *info, same result as parse_wifi_WifiSoftAPInfo
+ *  - return: 0 on success, -1 on failure
+ */
+int nanopb_view_copy(const nanopb_softap_view_t* view, wifi_softap_info_t* info) {
+    if (!view || !info) return -1;
+
+    const wifi_view_WifiSoftAPInfo* message = &view->message;
+    info->device_count = message->device_count;
+    info->state = message->state;
+
+    /* an empty fixed length value decodes as zeros */
+    if (message->has_ip_address) {
+        if (view->ipv4.size) {
+            memcpy(info->ip_address.ipv4, view->ipv4.bytes, IPV4_LEN);
+        } else {
+            memset(info->ip_address.ipv4, 0, IPV4_LEN);
+        }
+        if (view->ipv6.size) {
+            memcpy(info->ip_address.ipv6, view->ipv6.bytes, IPV6_LEN);
+        } else {
+            memset(info->ip_address.ipv6, 0, IPV6_LEN);
+        }
+    }
+
+    size_t sslen = view->ssid.size;
+    if (sslen > WIFI_SSID_MAX_LEN) sslen = WIFI_SSID_MAX_LEN;
+    if (sslen) memcpy(info->ssid, view->ssid.bytes, sslen);
+    info->ssid[sslen] = '\0';
+
+    if (view->bssid.size) {
+        memcpy(info->bssid, view->bssid.bytes, WIFI_BT_MAC_ADDRESS_LEN);
+    } else {
+        memset(info->bssid, 0, WIFI_BT_MAC_ADDRESS_LEN);
+    }
+
+    info->security = message->security;
+    info->channel = (uint8_t)message->channel;
+    info->frequency = message->frequency;
+    return 0;
+}
+
+/* nanopb_view in the demo: decode to views, then one copy per field */
+int nanopb_view_decode(void* buffer, size_t size, wifi_softap_info_t* out_info) {
+    nanopb_softap_view_t view;
+    if (nanopb_decode_view(buffer, size, &view) != 0) return -1;
+    return nanopb_view_copy(&view, out_info);
+}
+
+typedef struct {
+    nanopb_softap_view_t view;
+    wifi_softap_info_t* out_infos;
+} nanopb_view_list_t;
+
+bool nanopb_view_decode_ap(pb_istream_t* substream, int index, void* ctx) {
+    nanopb_view_list_t* list = (nanopb_view_list_t*)ctx;
+
+    nanopb_view_reset(&list->view);
+    if (!pb_decode(substream, wifi_view_WifiSoftAPInfo_fields, &list->view.message)) return false;
+    nanopb_view_copy(&list->view, &list->out_infos[index]);
+    return true;
+}
+
+int nanopb_view_decode_array(void* buf, size_t size, wifi_softap_info_t* out_infos, int* out_count) {
+    if (!buf || size == 0 || !out_infos || !out_count) return -1;
+
+    nanopb_view_list_t list;
+    list.out_infos = out_infos;
+    return nanopb_decode_ap_list(buf, size, nanopb_view_decode_ap, &list, out_count);
+}
+
+/* ---------- nanopb_fast: generated straight-line codec ---------- */
+/*
+ * Same messages and bytes as above, but encoded/decoded with the functions
+ * that fastpb_generator.py generates from sample_structure.proto
+ * (sample_structure.fastpb.*) instead of walking wifi_*_fields.
+ */
+
+/*
+ * nanopb_fast_encode
+ *  - input: wifi_softap_info_t *info
+ *  - output: *out_buffer, *out_size
+ *  - return: 0 on success, -1 on failure
+ */
+int nanopb_fast_encode(const wifi_softap_info_t* info, void* out_buffer, size_t* out_size) {
+    if (!info || !out_buffer || !out_size) return -1;
+
+    wifi_WifiSoftAPInfo message = wifi_WifiSoftAPInfo_init_zero;
+    if (parse_wifi_softap_info(info, &message) != 0) {
+        return -1;
+    }
+
+    if (!wifi_WifiSoftAPInfo_fast_encode(&message, (pb_byte_t*)out_buffer, MAX_BUFFER, out_size)) {
+        fprintf(stderr, "Nanopb fast encode failed\n");
+        return -1;
+    }
+    return 0;
+}
+
+/*
+ * nanopb_fast_decode
+ *  - input: *buffer, size
+ *  - output: wifi_softap_info_t *info
+ *  - return: 0 on success, -1 on failure
+ */
+int nanopb_fast_decode(void* buffer, size_t size, wifi_softap_info_t* out_info) {
+    if (!buffer || size == 0 || !out_info) return -1;
+
+    wifi_WifiSoftAPInfo message;
+    if (!wifi_WifiSoftAPInfo_fast_decode(&message, (const pb_byte_t*)buffer, size)) {
+        fprintf(stderr, "Nanopb fast decode failed\n");
+        return -1;
+    }
+
+    parse_wifi_WifiSoftAPInfo(&message, out_info);
+    return 0;
+}
+
+/*
+ * nanopb_fast_encode_array
+ *  - input: wifi_softap_info_t *infos, int count
+ *  - output: *out_buffer, *out_size
+ *  - return: 0 on success, -1 on failure
+ */
+int nanopb_fast_encode_array(const wifi_softap_info_t* infos, int count, void* out_buffer, size_t* out_size) {
+    if (!infos || count == 0 || !out_buffer || !out_size) return -1;
+
+    wifi_WifiSoftAPList list = wifi_WifiSoftAPList_init_zero;
+    for (size_t i = 0; i < count; i++) {
+        if (parse_wifi_softap_info(&infos[i], &list.ap_list[i]) != 0) {
+            return -1;
+        }
+    }
+    list.ap_list_count = count;
+
+    if (!wifi_WifiSoftAPList_fast_encode(&list, (pb_byte_t*)out_buffer, MAX_BUFFER, out_size)) {
+        fprintf(stderr, "Nanopb fast encode failed\n");
+        return -1;
+    }
+    return 0;
+}
+
+/*
+ * nanopb_fast_decode_array
+ *  - input: *buf, size
+ *  - output: wifi_softap_info_t *out_infos, *out_count
+ *  - return: 0 on success, -1 on failure
+ */
+int nanopb_fast_decode_array(void* buf, size_t size, wifi_softap_info_t* out_infos, int* out_count) {
+    if (!buf || size == 0 || !out_infos || !out_count) return -1;
+
+    wifi_WifiSoftAPList list;
+    if (!wifi_WifiSoftAPList_fast_decode(&list, (const pb_byte_t*)buf, size)) {
+        fprintf(stderr, "Nanopb fast decode failed\n");
+        return -1;
+    }
+
+    *out_count = list.ap_list_count;
+    for (size_t i = 0; i < list.ap_list_count; i++) {
+        parse_wifi_WifiSoftAPInfo(&list.ap_list[i], out_infos + i);
+    }
+    return 0;
+}
+
+/* ---------- nanopb_direct: descriptors on the native structs ---------- */
+/*
+ * The same wire format as wifi.IPAddr / wifi.WifiSoftAPInfo, but the field
+ * descriptors are bound to ip_addr_t and wifi_softap_info_t themselves, so
+ * pb_encode/pb_decode read and write our structs with no staging message:
+ *  - ipv4, ipv6, bssid: FIXED_LENGTH_BYTES over the raw arrays (always sent),
+ *    as in sample_structure.options
+ *  - ssid: STRING over the NUL-terminated char array (empty is not sent)
+ *  - ip_address: SINGULAR submessage without has_ flag (always sent)
+ *  - state, security: enums, INT32 of sizeof(enum); channel / frequency:
+ *    UINT32 of 1 / 2 bytes, nanopb range-checks them on decode
+ * Lists are not bound to a struct: each record is written as an ap_list
+ * (tag 1) submessage straight from the caller's array, and read back the
+ * same way.
+ */
+#define wifi_native_IPAddr_FIELDLIST(X, a) \
+X(a, STATIC,   SINGULAR, FIXED_LENGTH_BYTES, ipv4,  1) \
+X(a, STATIC,   SINGULAR, FIXED_LENGTH_BYTES, ipv6,  2)
+#define wifi_native_IPAddr_CALLBACK NULL
+#define wifi_native_IPAddr_DEFAULT NULL
+
+#define wifi_native_WifiSoftAPInfo_FIELDLIST(X, a) \
+X(a, STATIC,   SINGULAR, INT32,    device_count,      1) \
+X(a, STATIC,   SINGULAR, INT32,    state,             2) \
+X(a, STATIC,   SINGULAR, MESSAGE,  ip_address,        3) \
+X(a, STATIC,   SINGULAR, STRING,   ssid,              4) \
+X(a, STATIC,   SINGULAR, FIXED_LENGTH_BYTES, bssid,   5) \
+X(a, STATIC,   SINGULAR, INT32,    security,          6) \
+X(a, STATIC,   SINGULAR, UINT32,   channel,           7) \
+X(a, STATIC,   SINGULAR, UINT32,   frequency,         8)
+#define wifi_native_WifiSoftAPInfo_CALLBACK NULL
+#define wifi_native_WifiSoftAPInfo_DEFAULT NULL
+#define wifi_softap_info_t_ip_address_MSGTYPE ip_addr_t
+
+PB_BIND(wifi_native_IPAddr, ip_addr_t, AUTO)
+PB_BIND(wifi_native_WifiSoftAPInfo, wifi_softap_info_t, AUTO)
+
+#define wifi_native_IPAddr_fields &ip_addr_t_msg
+#define wifi_native_WifiSoftAPInfo_fields &wifi_softap_info_t_msg
+
+/*
+ * Sized emission
+ * pb_encode_submessage() encodes every submessage twice: once into a sizing
+ * stream for its length prefix, then for real. A list record therefore
+ * encodes its ip_address four times. Instead, sizes are computed bottom-up
+ * once per record (ip_address is constant: both fields are fixed length and
+ * always sent), then one pass writes tags, length prefixes and values with
+ * the pb_encode_* primitives, in the descriptor's field order and with its
+ * proto3 rule (zero / empty fields are not sent). Bytes are identical to
+ * pb_encode() on wifi_native_WifiSoftAPInfo_fields.
+ */
+#define NANOPB_IP_ADDRESS_SIZE (1 + 1 + IPV4_LEN + 1 + 1 + IPV6_LEN)
+
+static inline size_t nanopb_varint_size(uint64_t value) {
+    size_t size = 1;
+    while (value >= 0x80) {
+        value >>= 7;
+        size++;
+    }
+    return size;
+}
+
+/* int32 fields are sign-extended to 64 bits on the wire, like pb_enc_varint */
+#define NANOPB_INT32_SIZE(v) nanopb_varint_size((uint64_t)(int64_t)(int32_t)(v))
+
+/*
+ * nanopb_softap_info_size
+ *  - input: wifi_softap_info_t *info
+ *  - return: encoded size of the record body, 0 if ssid is not terminated
+ */
+size_t nanopb_softap_info_size(const wifi_softap_info_t* info) {
+    size_t ssid_len = strnlen(info->ssid, sizeof(info->ssid));
+    if (ssid_len == sizeof(info->ssid)) return 0;
+
+    size_t size = 1 + 1 + NANOPB_IP_ADDRESS_SIZE + 1 + 1 + WIFI_BT_MAC_ADDRESS_LEN;
+    if (info->device_count) size += 1 + NANOPB_INT32_SIZE(info->device_count);
+    if (info->state) size += 1 + NANOPB_INT32_SIZE(info->state);
+    if (ssid_len) size += 1 + nanopb_varint_size(ssid_len) + ssid_len;
+    if (info->security) size += 1 + NANOPB_INT32_SIZE(info->security);
+    if (info->channel) size += 1 + nanopb_varint_size(info->channel);
+    if (info->frequency) size += 1 + nanopb_varint_size(info->frequency);
+    return size;
+}
+
+bool nanopb_encode_softap_body(pb_ostream_t* stream, const wifi_softap_info_t* info) {
+    if (info->device_count &&
+        (!pb_encode_tag(stream, PB_WT_VARINT, wifi_WifiSoftAPInfo_device_count_tag) ||
+         !pb_encode_varint(stream, (uint64_t)(int64_t)(int32_t)info->device_count))) {
+        return false;
+    }
+    if (info->state &&
+        (!pb_encode_tag(stream, PB_WT_VARINT, wifi_WifiSoftAPInfo_state_tag) ||
+         !pb_encode_varint(stream, (uint64_t)(int64_t)(int32_t)info->state))) {
+        return false;
+    }
+    if (!pb_encode_tag(stream, PB_WT_STRING, wifi_WifiSoftAPInfo_ip_address_tag) ||
+        !pb_encode_varint(stream, NANOPB_IP_ADDRESS_SIZE) ||
+        !pb_encode_tag(stream, PB_WT_STRING, wifi_IPAddr_ipv4_tag) ||
+        !pb_encode_string(stream, info->ip_address.ipv4, IPV4_LEN) ||
+        !pb_encode_tag(stream, PB_WT_STRING, wifi_IPAddr_ipv6_tag) ||
+        !pb_encode_string(stream, info->ip_address.ipv6, IPV6_LEN)) {
+        return false;
+    }
+    size_t ssid_len = strnlen(info->ssid, sizeof(info->ssid));
+    if (ssid_len == sizeof(info->ssid)) PB_RETURN_ERROR(stream, "unterminated string");
+    if (ssid_len &&
+        (!pb_encode_tag(stream, PB_WT_STRING, wifi_WifiSoftAPInfo_ssid_tag) ||
+         !pb_encode_string(stream, (const pb_byte_t*)info->ssid, ssid_len))) {
+        return false;
+    }
+    if (!pb_encode_tag(stream, PB_WT_STRING, wifi_WifiSoftAPInfo_bssid_tag) ||
+        !pb_encode_string(stream, info->bssid, WIFI_BT_MAC_ADDRESS_LEN)) {
+        return false;
+    }
+    if (info->security &&
+        (!pb_encode_tag(stream, PB_WT_VARINT, wifi_WifiSoftAPInfo_security_tag) ||
+         !pb_encode_varint(stream, (uint64_t)(int64_t)(int32_t)info->security))) {
+        return false;
+    }
+    if (info->channel &&
+        (!pb_encode_tag(stream, PB_WT_VARINT, wifi_WifiSoftAPInfo_channel_tag) ||
+         !pb_encode_varint(stream, info->channel))) {
+        return false;
+    }
+    if (info->frequency &&
+        (!pb_encode_tag(stream, PB_WT_VARINT, wifi_WifiSoftAPInfo_frequency_tag) ||
+         !pb_encode_varint(stream, info->frequency))) {
+        return false;
+    }
+    return true;
+}
+
+/* Length-prefixed record, the tag is written by the caller */
+bool nanopb_encode_softap_submessage(pb_ostream_t* stream, const wifi_softap_info_t* info) {
+    size_t size = nanopb_softap_info_size(info);
+    if (size == 0) PB_RETURN_ERROR(stream, "unterminated string");
+    if (!pb_encode_varint(stream, (uint64_t)size)) return false;
+
+    size_t start = stream->bytes_written;
+    if (!nanopb_encode_softap_body(stream, info)) return false;
+    if (stream->bytes_written - start != size) PB_RETURN_ERROR(stream, "submsg size changed");
+    return true;
+}
+
+/*
+ * nanopb_direct_encode
+ *  - input: wifi_softap_info_t *info
+ *  - output: *out_buffer, *out_size
+ *  - return: 0 on success, -1 on failure
+ */
+int nanopb_direct_encode(const wifi_softap_info_t* info, void* out_buffer, size_t* out_size) {
+    if (!info || !out_buffer || !out_size) return -1;
+
+    pb_ostream_t stream = pb_ostream_from_buffer(out_buffer, MAX_BUFFER);
+    if (!nanopb_encode_softap_body(&stream, info)) {
+        fprintf(stderr, "Nanopb encode failed: %s\n", PB_GET_ERROR(&stream));
+        return -1;
+    }
+
+    *out_size = stream.bytes_written;
+    return 0;
+}
+
+/*
+ * nanopb_direct_decode
+ *  - input: *buffer, size
+ *  - output: wifi_softap_info_t *info
+ *  - return: 0 on success, -1 on failure
+ */
+int nanopb_direct_decode(void* buffer, size_t size, wifi_softap_info_t* out_info) {
+    if (!buffer || size == 0 || !out_info) return -1;
+
+    pb_istream_t stream = pb_istream_from_buffer((const pb_byte_t*)buffer, size);
+    if (!pb_decode(&stream, wifi_native_WifiSoftAPInfo_fields, out_info)) {
+        fprintf(stderr, "Nanopb decode failed: %s\n", PB_GET_ERROR(&stream));
+        return -1;
+    }
+    return 0;
+}
+
+/*
+ * nanopb_direct_encode_array
+ *  - input: wifi_softap_info_t *infos, int count
+ *  - output: *out_buffer, *out_size (a wifi.WifiSoftAPList message)
+ *  - return: 0 on success, -1 on failure
+ */
+int nanopb_direct_encode_array(const wifi_softap_info_t* infos, int count, void* out_buffer, size_t* out_size) {
+    if (!infos || count == 0 || !out_buffer || !out_size) return -1;
+
+    pb_ostream_t stream = pb_ostream_from_buffer(out_buffer, MAX_BUFFER);
+    for (int i = 0; i < count; i++) {
+        if (!pb_encode_tag(&stream, PB_WT_STRING, wifi_WifiSoftAPList_ap_list_tag) ||
+            !nanopb_encode_softap_submessage(&stream, &infos[i])) {
+            fprintf(stderr, "Nanopb encode failed: %s\n", PB_GET_ERROR(&stream));
+            return -1;
+        }
+    }
+
+    *out_size = stream.bytes_written;
+    return 0;
+}
+
+bool nanopb_direct_decode_ap(pb_istream_t* substream, int index, void* ctx) {
+    wifi_softap_info_t* out_infos = (wifi_softap_info_t*)ctx;
+    return pb_decode(substream, wifi_native_WifiSoftAPInfo_fields, &out_infos[index]);
+}
+
+/*
+ * nanopb_direct_decode_array
+ *  - input: *buf, size (a wifi.WifiSoftAPList message, at most MAX_ARRAY records)
+ *  - output: wifi_softap_info_t *out_infos, *out_count
+ *  - return: 0 on success, -1 on failure
+ */
+int nanopb_direct_decode_array(void* buf, size_t size, wifi_softap_info_t* out_infos, int* out_count) {
+    if (!buf || size == 0 || !out_infos || !out_count) return -1;
+
+    return nanopb_decode_ap_list(buf, size, nanopb_direct_decode_ap, out_infos, out_count);
+}
+/*
+ * Streaming ap_list (nanopb_stream)
+ * wifi_WifiSoftAPList holds ap_list as a static wifi_WifiSoftAPInfo[20]: the
+ * list struct is ~2.5 KB to zero-init and caps a message at 20 records.
+ * nanopb_softap_list_t binds the same tag 1 as a CALLBACK field instead, so
+ * records are pulled from a caller iterator on encode and pushed to a caller
+ * sink on decode, one wifi_softap_info_t at a time. Memory is bounded by one
+ * record regardless of count; the pb_ostream_t / pb_istream_t may be backed by
+ * a buffer or by a socket callback.
+ *  - next: returns record index of the list to encode, NULL past the end.
+ *    nanopb may call the encode callback more than once (a sizing pass when
+ *    the list is itself a submessage), each call walks the list from index 0
+ *  - sink: consumes one decoded record, returns 0 to continue, -1 to abort
+ */
+typedef const wifi_softap_info_t* (*nanopb_softap_next_t)(const void* ctx, size_t index);
+typedef int (*nanopb_softap_sink_t)(void* ctx, const wifi_softap_info_t* info);
+
+typedef struct {
+    nanopb_softap_next_t next;
+    const void* ctx;
+} nanopb_softap_source_t;
+
+typedef struct {
+    nanopb_softap_sink_t sink;
+    void* ctx;
+} nanopb_softap_target_t;
+
+typedef struct {
+    pb_callback_t ap_list;
+} nanopb_softap_list_t;
+
+#define wifi_stream_WifiSoftAPList_FIELDLIST(X, a) \
+X(a, CALLBACK, REPEATED, MESSAGE,  ap_list,           1)
+#define wifi_stream_WifiSoftAPList_CALLBACK pb_default_field_callback
+#define wifi_stream_WifiSoftAPList_DEFAULT NULL
+#define nanopb_softap_list_t_ap_list_MSGTYPE wifi_softap_info_t
+
+PB_BIND(wifi_stream_WifiSoftAPList, nanopb_softap_list_t, AUTO)
+
+#define wifi_stream_WifiSoftAPList_fields &nanopb_softap_list_t_msg
+
+bool nanopb_stream_encode_ap(pb_ostream_t* stream, const pb_field_t* field, void* const* arg) {
+    const nanopb_softap_source_t* source = (const nanopb_softap_source_t*)*arg;
+    const wifi_softap_info_t* info;
+
+    for (size_t i = 0; (info = source->next(source->ctx, i)) != NULL; i++) {
+        if (!pb_encode_tag_for_field(stream, field) ||
+            !nanopb_encode_softap_submessage(stream, info)) {
+            return false;
+        }
+    }
+    return true;
+}
+
+bool nanopb_stream_decode_ap(pb_istream_t* stream, const pb_field_t* field, void** arg) {
+    const nanopb_softap_target_t* target = (const nanopb_softap_target_t*)*arg;
+    wifi_softap_info_t info;
+    (void)field;
+
+    if (!pb_decode(stream, wifi_native_WifiSoftAPInfo_fields, &info)) return false;
+    if (target->sink(target->ctx, &info) != 0) PB_RETURN_ERROR(stream, "sink rejected record");
+    return true;
+}
+
+/*
+ * nanopb_encode_list_stream
+ *  - input: pb_ostream_t *stream, next / ctx indexing the records
+ *  - output: the encoded list written to stream
+ *  - return: 0 on success, -1 on failure
+ */
+int nanopb_encode_list_stream(pb_ostream_t* stream, nanopb_softap_next_t next, const void* ctx) {
+    if (!stream || !next) return -1;
+
+    nanopb_softap_source_t source = {next, ctx};
+    nanopb_softap_list_t list;
+    list.ap_list.funcs.encode = nanopb_stream_encode_ap;
+    list.ap_list.arg = &source;
+
+    if (!pb_encode(stream, wifi_stream_WifiSoftAPList_fields, &list)) {
+        fprintf(stderr, "Nanopb encode failed: %s\n", PB_GET_ERROR(stream));
+        return -1;
+    }
+    return 0;
+}
+
+/*
+ * nanopb_decode_list_stream
+ *  - input: pb_istream_t *stream, sink / ctx receiving every decoded record
+ *  - output: records passed to sink in wire order
+ *  - return: 0 on success, -1 on failure
+ */
+int nanopb_decode_list_stream(pb_istream_t* stream, nanopb_softap_sink_t sink, void* ctx) {
+    if (!stream || !sink) return -1;
+
+    nanopb_softap_target_t target = {sink, ctx};
+    nanopb_softap_list_t list;
+    list.ap_list.funcs.decode = nanopb_stream_decode_ap;
+    list.ap_list.arg = &target;
+
+    if (!pb_decode(stream, wifi_stream_WifiSoftAPList_fields, &list)) {
+        fprintf(stderr, "Nanopb decode failed: %s\n", PB_GET_ERROR(stream));
+        return -1;
+    }
+    return 0;
+}
+
+/* Source / sink over a plain wifi_softap_info_t array */
+typedef struct {
+    const wifi_softap_info_t* infos;
+    int count;
+} nanopb_softap_span_t;
+
+typedef struct {
+    wifi_softap_info_t* infos;
+    int capacity;
+    int count;
+} nanopb_softap_array_t;
+
+const wifi_softap_info_t* nanopb_array_next(const void* ctx, size_t index) {
+    const nanopb_softap_span_t* span = (const nanopb_softap_span_t*)ctx;
+    if (index >= (size_t)span->count) return NULL;
+    return &span->infos[index];
+}
+
+int nanopb_array_sink(void* ctx, const wifi_softap_info_t* info) {
+    nanopb_softap_array_t* array = (nanopb_softap_array_t*)ctx;
+    if (array->count >= array->capacity) return -1;
+    array->infos[array->count++] = *info;
+    return 0;
+}
+
+/*
+ * nanopb_stream_encode_array
+ *  - input: wifi_softap_info_t *infos, int count
+ *  - output: *out_buffer, *out_size
+ *  - return: 0 on success, -1 on failure
+ */
+int nanopb_stream_encode_array(const wifi_softap_info_t* infos, int count, void* out_buffer, size_t* out_size) {
+    if (!infos || count == 0 || !out_buffer || !out_size) return -1;
+
+    nanopb_softap_span_t span = {infos, count};
+    pb_ostream_t stream = pb_ostream_from_buffer(out_buffer, MAX_BUFFER);
+    if (nanopb_encode_list_stream(&stream, nanopb_array_next, &span) != 0) return -1;
+
+    *out_size = stream.bytes_written;
+    return 0;
+}
+
+/*
+ * nanopb_stream_decode_array
+ *  - input: void *buf, size_t size
+ *  - output: *out_infos (1 to MAX_ARRAY), *out_count
+ *  - return: 0 on success, -1 on failure (an empty list too, like the encoder)
+ */
+int nanopb_stream_decode_array(void* buf, size_t size, wifi_softap_info_t* out_infos, int* out_count) {
+    if (!buf || size == 0 || !out_infos || !out_count) return -1;
+
+    nanopb_softap_array_t array = {out_infos, MAX_ARRAY, 0};
+    pb_istream_t stream = pb_istream_from_buffer((const pb_byte_t*)buf, size);
+    if (nanopb_decode_list_stream(&stream, nanopb_array_sink, &array) != 0) return -1;
+    if (array.count == 0) {
+        fprintf(stderr, "Nanopb decode failed: empty ap_list\n");
+        return -1;
+    }
+
+    *out_count = array.count;
+    return 0;
+}
+
 #endif /* NANOPB_USAGE_H */
\ No newline at end of file
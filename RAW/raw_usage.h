@@ -0,0 +1,185 @@
+/* RAW/raw_usage.h
+ *
+ * Requires: nothing but sample_structure.h (baseline, no library)
+ * Exports:
+ *   int raw_encode(const wifi_softap_info_t *info, void *out_buffer, size_t *out_size);
+ *   int raw_decode(void *buffer, size_t size, wifi_softap_info_t *out_info);
+ *   int raw_encode_array(const wifi_softap_info_t *infos, int count, void *out_buffer, size_t *out_size);
+ *   int raw_decode_array(void *buf, size_t size, wifi_softap_info_t *out_infos, int *out_count);
+ *
+ * Notes:
+ * - The floor for the other codecs: a record is raw_softap_record_t, the
+ *   fields of wifi_softap_info_t in declaration order with no padding and
+ *   fixed-width little-endian integers. On a little-endian host encode and
+ *   decode are field copies, the byte swap is only compiled on big-endian.
+ * - The layout is checked at compile time, a change to the struct that
+ *   would change the bytes on the wire does not build.
+ * - A single record is just the record (RAW_RECORD_SIZE bytes); an array is
+ *   a little-endian uint32 count followed by count records.
+ * - ssid is copied as the whole WIFI_SSID_MAX_LEN + 1 array, bytes after
+ *   the terminator included, like a memcpy of the struct would.
+ * - No version, no field tags, no validation beyond sizes and the ssid
+ *   terminator: it is a baseline, not a format to evolve.
+ */
+
+#ifndef RAW_USAGE_H
+#define RAW_USAGE_H
+
+#include <stddef.h>
+
+#include "../sample_structure.h" /* defines wifi_softap_info_t, constants */
+
+typedef struct __attribute__((packed)) {
+    int32_t device_count;
+    int32_t state;
+    uint8_t ipv4[IPV4_LEN];
+    uint8_t ipv6[IPV6_LEN];
+    char ssid[WIFI_SSID_MAX_LEN + 1];
+    uint8_t bssid[WIFI_BT_MAC_ADDRESS_LEN];
+    int32_t security;
+    uint8_t channel;
+    uint16_t frequency;
+} raw_softap_record_t;
+
+#define RAW_RECORD_SIZE 74
+#define RAW_COUNT_SIZE 4
+
+_Static_assert(sizeof(raw_softap_record_t) == RAW_RECORD_SIZE, "raw record size");
+_Static_assert(offsetof(raw_softap_record_t, device_count) == 0, "raw device_count offset");
+_Static_assert(offsetof(raw_softap_record_t, state) == 4, "raw state offset");
+_Static_assert(offsetof(raw_softap_record_t, ipv4) == 8, "raw ipv4 offset");
+_Static_assert(offsetof(raw_softap_record_t, ipv6) == 12, "raw ipv6 offset");
+_Static_assert(offsetof(raw_softap_record_t, ssid) == 28, "raw ssid offset");
+_Static_assert(offsetof(raw_softap_record_t, bssid) == 61, "raw bssid offset");
+_Static_assert(offsetof(raw_softap_record_t, security) == 67, "raw security offset");
+_Static_assert(offsetof(raw_softap_record_t, channel) == 71, "raw channel offset");
+_Static_assert(offsetof(raw_softap_record_t, frequency) == 72, "raw frequency offset");
+/* the source fields must fit the record fields they are copied to */
+_Static_assert(sizeof(((wifi_softap_info_t*)0)->device_count) == sizeof(int32_t), "device_count width");
+_Static_assert(sizeof(((wifi_softap_info_t*)0)->ip_address.ipv4) == IPV4_LEN, "ipv4 width");
+_Static_assert(sizeof(((wifi_softap_info_t*)0)->ip_address.ipv6) == IPV6_LEN, "ipv6 width");
+_Static_assert(sizeof(((wifi_softap_info_t*)0)->ssid) == WIFI_SSID_MAX_LEN + 1, "ssid width");
+
+#if defined(__BYTE_ORDER__) && __BYTE_ORDER__ == __ORDER_BIG_ENDIAN__
+#define RAW_LE16(x) __builtin_bswap16(x)
+#define RAW_LE32(x) __builtin_bswap32(x)
+#else
+#define RAW_LE16(x) (x)
+#define RAW_LE32(x) (x)
+#endif
+
+static inline void raw_put_record(raw_softap_record_t* record, const wifi_softap_info_t* info) {
+    record->device_count = (int32_t)RAW_LE32((uint32_t)info->device_count);
+    record->state = (int32_t)RAW_LE32((uint32_t)info->state);
+    memcpy(record->ipv4, info->ip_address.ipv4, IPV4_LEN);
+    memcpy(record->ipv6, info->ip_address.ipv6, IPV6_LEN);
+    memcpy(record->ssid, info->ssid, sizeof(record->ssid));
+    memcpy(record->bssid, info->bssid, WIFI_BT_MAC_ADDRESS_LEN);
+    record->security = (int32_t)RAW_LE32((uint32_t)info->security);
+    record->channel = info->channel;
+    record->frequency = RAW_LE16(info->frequency);
+}
+
+static inline int raw_get_record(const raw_softap_record_t* record, wifi_softap_info_t* info) {
+    if (record->ssid[WIFI_SSID_MAX_LEN] != '\0') {
+        fprintf(stderr, "Raw decode failed: ssid not terminated\n");
+        return -1;
+    }
+    info->device_count = (int32_t)RAW_LE32((uint32_t)record->device_count);
+    info->state = (wifi_softap_state_t)(int32_t)RAW_LE32((uint32_t)record->state);
+    memcpy(info->ip_address.ipv4, record->ipv4, IPV4_LEN);
+    memcpy(info->ip_address.ipv6, record->ipv6, IPV6_LEN);
+    memcpy(info->ssid, record->ssid, sizeof(info->ssid));
+    memcpy(info->bssid, record->bssid, WIFI_BT_MAC_ADDRESS_LEN);
+    info->security = (security_type_t)(int32_t)RAW_LE32((uint32_t)record->security);
+    info->channel = record->channel;
+    info->frequency = RAW_LE16(record->frequency);
+    return 0;
+}
+
+/*
+ * raw_encode
+ *  - input: wifi_softap_info_t *info
+ *  - output: *out_buffer, *out_size
+ *  - return: 0 on success, -1 on failure
+ */
+int raw_encode(const wifi_softap_info_t* info, void* out_buffer, size_t* out_size) {
+    if (!info || !out_buffer || !out_size) return -1;
+
+    raw_put_record((raw_softap_record_t*)out_buffer, info);
+    *out_size = RAW_RECORD_SIZE;
+    return 0;
+}
+
+/*
+ * raw_decode
+ *  - input: *buffer, size
+ *  - output: wifi_softap_info_t *out_info
+ *  - return: 0 on success, -1 on failure
+ */
+int raw_decode(void* buffer, size_t size, wifi_softap_info_t* out_info) {
+    if (!buffer || !out_info) return -1;
+    if (size != RAW_RECORD_SIZE) {
+        fprintf(stderr, "Raw decode failed: %zu bytes, expected %d\n", size, RAW_RECORD_SIZE);
+        return -1;
+    }
+
+    return raw_get_record((const raw_softap_record_t*)buffer, out_info);
+}
+
+/*
+ * raw_encode_array
+ *  - input: wifi_softap_info_t *infos, int count
+ *  - output: *out_buffer, *out_size
+ *  - return: 0 on success, -1 on failure
+ */
+int raw_encode_array(const wifi_softap_info_t* infos, int count, void* out_buffer, size_t* out_size) {
+    if (!infos || count <= 0 || !out_buffer || !out_size) return -1;
+
+    size_t size = RAW_COUNT_SIZE + (size_t)count * RAW_RECORD_SIZE;
+    if (size > MAX_BUFFER) {
+        fprintf(stderr, "Raw encode failed: %d records do not fit\n", count);
+        return -1;
+    }
+
+    uint32_t le_count = RAW_LE32((uint32_t)count);
+    memcpy(out_buffer, &le_count, RAW_COUNT_SIZE);
+    raw_softap_record_t* records = (raw_softap_record_t*)((uint8_t*)out_buffer + RAW_COUNT_SIZE);
+    for (int i = 0; i < count; i++) {
+        raw_put_record(&records[i], &infos[i]);
+    }
+
+    *out_size = size;
+    return 0;
+}
+
+/*
+ * raw_decode_array
+ *  - input: *buf, size
+ *  - output: wifi_softap_info_t *out_infos (up to MAX_ARRAY), *out_count
+ *  - return: 0 on success, -1 on failure
+ */
+int raw_decode_array(void* buf, size_t size, wifi_softap_info_t* out_infos, int* out_count) {
+    if (!buf || !out_infos || !out_count) return -1;
+    if (size < RAW_COUNT_SIZE) {
+        fprintf(stderr, "Raw decode failed: no record count\n");
+        return -1;
+    }
+
+    uint32_t count;
+    memcpy(&count, buf, RAW_COUNT_SIZE);
+    count = RAW_LE32(count);
+    if (count > MAX_ARRAY || size != RAW_COUNT_SIZE + (size_t)count * RAW_RECORD_SIZE) {
+        fprintf(stderr, "Raw decode failed: %u records in %zu bytes\n", count, size);
+        return -1;
+    }
+
+    const raw_softap_record_t* records = (const raw_softap_record_t*)((const uint8_t*)buf + RAW_COUNT_SIZE);
+    for (uint32_t i = 0; i < count; i++) {
+        if (raw_get_record(&records[i], &out_infos[i]) != 0) return -1;
+    }
+    *out_count = (int)count;
+    return 0;
+}
+
+#endif /* RAW_USAGE_H */
@@ -97,10 +97,10 @@ typedef unsigned __int64 uint64_t;
 #define fatal_oom() tpl_hook.fatal("out of memory\n")
 
 /* bit flags (internal). preceded by the external flags in tpl.h */
-#define TPL_WRONLY         (1 << 9)  /* app has initiated tpl packing  */
-#define TPL_RDONLY         (1 << 10)  /* tpl was loaded (for unpacking) */
-#define TPL_XENDIAN        (1 << 11)  /* swap endianness when unpacking */
-#define TPL_OLD_STRING_FMT (1 << 12) /* tpl has strings in 1.2 format */
+#define TPL_WRONLY         (1 << 10)  /* app has initiated tpl packing  */
+#define TPL_RDONLY         (1 << 11)  /* tpl was loaded (for unpacking) */
+#define TPL_XENDIAN        (1 << 12)  /* swap endianness when unpacking */
+#define TPL_OLD_STRING_FMT (1 << 13) /* tpl has strings in 1.2 format */
 
 /* values for the flags byte that appears after the magic prefix */
 #define TPL_SUPPORTED_BITFLAGS 3
@@ -175,6 +175,10 @@ typedef struct tpl_root_data {
     tpl_mmap_rec mmap;
     char *fmt;
     int *fxlens, num_fxlens;
+    char *trusted_pre;        /* TPL_TRUSTED: flags byte + fmt + # lens */
+    size_t trusted_pre_sz;
+    size_t trusted_fixed_sz;  /* TPL_TRUSTED: data size of a fixed-size root */
+    size_t trusted_elem_sz;   /* or of one element of the single root A() */
 } tpl_root_data;
 
 /* node type to size mapping */
@@ -198,6 +202,7 @@ static int tpl_mmap_file(char *filename, tpl_mmap_rec *map_rec);
 static int tpl_mmap_output_file(char *filename, size_t sz, void **text_out);
 static int tpl_cpu_bigendian(void);
 static int tpl_needs_endian_swap(void *);
+static int tpl_sanity_trusted(tpl_node *r);
 static void tpl_byteswap(void *word, int len);
 static void tpl_fatal(const char *fmt, ...);
 static int tpl_serlen(tpl_node *r, tpl_node *n, void *dv, size_t *serlen);
@@ -786,6 +791,9 @@ TPL_API void tpl_free(tpl_node *r) {
         tpl_hook.free(pidx);
     }
     tpl_hook.free(((tpl_root_data*)(r->data))->fmt);
+    if (((tpl_root_data*)(r->data))->trusted_pre) {
+        tpl_hook.free(((tpl_root_data*)(r->data))->trusted_pre);
+    }
     if (((tpl_root_data*)(r->data))->num_fxlens > 0) {
         tpl_hook.free(((tpl_root_data*)(r->data))->fxlens);
     }
@@ -1270,6 +1278,88 @@ static void *tpl_find_data_start(void *d) {
     return d;
 }
 
+/* serialized size of one pass over n's children if they are all fixed-size
+ * types (no strings, bins, nested arrays or # groups), else 0 */
+static size_t tpl_fixed_sz(tpl_node *n) {
+    tpl_node *c;
+    size_t sz = 0;
+
+    for (c = n->children; c; c = c->next) {
+        switch (c->type) {
+            case TPL_TYPE_BYTE:
+            case TPL_TYPE_DOUBLE:
+            case TPL_TYPE_INT32:
+            case TPL_TYPE_UINT32:
+            case TPL_TYPE_INT64:
+            case TPL_TYPE_UINT64:
+            case TPL_TYPE_INT16:
+            case TPL_TYPE_UINT16:
+                sz += tpl_types[c->type].sz * c->num;
+                break;
+            default:
+                return 0;
+        }
+    }
+    return sz;
+}
+
+/*
+ * TPL_TRUSTED loads: the first image loaded into this map gets the full
+ * tpl_sanity walk. If it is same-endian, its preamble (flags byte, format
+ * string and # lengths) is cached on the root; later images only have their
+ * magic, internal size and preamble compared against that copy, skipping the
+ * per-char format scan, fxlens loop and tpl_serlen data walk.
+ * The data section is still checked on a hit, in O(1): only maps whose data
+ * size follows from the format are cached, i.e. a root of fixed-size types
+ * (data size must match) or a root holding one A() of fixed-size types (the
+ * A() count must match the data size). Other maps get tpl_sanity every time.
+ * Returns 1 on a cache hit (image known to need no swap), 0 when the full
+ * sanity check ran, or one of the ERR_ codes.
+ */
+static int tpl_sanity_trusted(tpl_node *r) {
+    tpl_root_data *rd = (tpl_root_data*)(r->data);
+    char *d = (char*)rd->mmap.text;
+    size_t bufsz = rd->mmap.text_sz;
+    size_t data_sz;
+    uint32_t intlsz, num;
+    int rc;
+
+    if (rd->trusted_pre == NULL) {
+        if ( (rc = tpl_sanity(r, 0)) != 0) return rc;
+        if (tpl_needs_endian_swap(d)) return 0; /* cross-endian: never cached */
+        rd->trusted_fixed_sz = tpl_fixed_sz(r);
+        rd->trusted_elem_sz = 0;
+        if (rd->trusted_fixed_sz == 0) {
+            if (!r->children || r->children->next || r->children->type != TPL_TYPE_ARY) return 0;
+            if ( (rd->trusted_elem_sz = tpl_fixed_sz(r->children)) == 0) return 0;
+        }
+        rd->trusted_pre_sz = (size_t)((char*)tpl_find_data_start(d) - (d + 8));
+        rd->trusted_pre = tpl_hook.malloc(rd->trusted_pre_sz + 1);
+        if (!rd->trusted_pre) fatal_oom();
+        rd->trusted_pre[0] = d[3];
+        memcpy(rd->trusted_pre + 1, d + 8, rd->trusted_pre_sz);
+        return 0;
+    }
+
+    if (bufsz < 8 + rd->trusted_pre_sz) return ERR_NOT_MINSIZE;
+    if (memcmp(d, TPL_MAGIC, 3) != 0) return ERR_MAGIC_MISMATCH;
+    if (d[3] != rd->trusted_pre[0]) return ERR_UNSUPPORTED_FLAGS;
+    memcpy(&intlsz, d + 4, sizeof(uint32_t));
+    if (intlsz != bufsz) return ERR_INCONSISTENT_SZ;
+    if (memcmp(d + 8, rd->trusted_pre + 1, rd->trusted_pre_sz) != 0) return ERR_FMT_MISMATCH;
+
+    data_sz = bufsz - 8 - rd->trusted_pre_sz;
+    if (rd->trusted_fixed_sz) {
+        if (data_sz != rd->trusted_fixed_sz) return ERR_INCONSISTENT_SZ;
+    } else {
+        if (data_sz < sizeof(uint32_t)) return ERR_INCONSISTENT_SZ;
+        memcpy(&num, d + 8 + rd->trusted_pre_sz, sizeof(uint32_t));
+        data_sz -= sizeof(uint32_t);
+        if (data_sz % rd->trusted_elem_sz != 0 || data_sz / rd->trusted_elem_sz != num) return ERR_INCONSISTENT_SZ;
+    }
+    return 1;
+}
+
 static int tpl_needs_endian_swap(void *d) {
     char *c;
     int cpu_is_bigendian;
@@ -1490,7 +1580,7 @@ fail:
 
 TPL_API int tpl_load(tpl_node *r, int mode, ...) {
     va_list ap;
-    int rc=0,fd=0;
+    int rc=0,fd=0,trusted_hit=0;
     char *filename=NULL;
     void *addr;
     size_t sz;
@@ -1536,7 +1626,16 @@ TPL_API int tpl_load(tpl_node *r, int mode, ...) {
     } else if (mode & TPL_MEM) {
         ((tpl_root_data*)(r->data))->mmap.text = addr;
         ((tpl_root_data*)(r->data))->mmap.text_sz = sz;
-        if ( (rc = tpl_sanity(r, (mode & TPL_EXCESS_OK))) != 0) {
+        if ((mode & TPL_TRUSTED) && !(mode & TPL_EXCESS_OK)) {
+            rc = tpl_sanity_trusted(r);
+            if (rc == 1) {
+                trusted_hit = 1;
+                rc = 0;
+            }
+        } else {
+            rc = tpl_sanity(r, (mode & TPL_EXCESS_OK));
+        }
+        if (rc != 0) {
             if (rc == ERR_FMT_MISMATCH) {
                 tpl_hook.oops("format signature mismatch\n");
             } else {
@@ -1555,8 +1654,8 @@ TPL_API int tpl_load(tpl_node *r, int mode, ...) {
         tpl_hook.oops("invalid tpl_load mode %d\n", mode);
         return -1;
     }
-    /* this applies to TPL_MEM or TPL_FILE */
-    if (tpl_needs_endian_swap(((tpl_root_data*)(r->data))->mmap.text))
+    /* this applies to TPL_MEM or TPL_FILE (a trusted hit is same-endian) */
+    if (!trusted_hit && tpl_needs_endian_swap(((tpl_root_data*)(r->data))->mmap.text))
         ((tpl_root_data*)(r->data))->flags |= TPL_XENDIAN;
     tpl_unpackA0(r);   /* prepare root A nodes for use */
     return 0;
@@ -1962,7 +2061,7 @@ TPL_API int tpl_pack(tpl_node *r, int i) {
 TPL_API int tpl_unpack(tpl_node *r, int i) {
     tpl_node *n, *c, *np;
     uint32_t slen;
-    int rc=1, fidx;
+    int rc=1, fidx, xendian;
     char *str;
     void *dv=NULL, *caddr;
     size_t A_bytes, itermax;
@@ -1981,6 +2080,9 @@ TPL_API int tpl_unpack(tpl_node *r, int i) {
         };
     }
 
+    /* read once: same-endian images then take the bulk memcpy paths below */
+    xendian = ((tpl_root_data*)(r->data))->flags & TPL_XENDIAN;
+
     n = tpl_find_i(r,i);
     if (n == NULL) {
         tpl_hook.oops("invalid index %d to tpl_unpack\n", i);
@@ -2009,7 +2111,7 @@ TPL_API int tpl_unpack(tpl_node *r, int i) {
             case TPL_TYPE_INT16:
             case TPL_TYPE_UINT16:
                 /* unpack elements of cross-endian octothorpic array individually */
-                if (((tpl_root_data*)(r->data))->flags & TPL_XENDIAN) {
+                if (xendian) {
                     for(fidx=0; fidx < c->num; fidx++) {
                         caddr = (void*)((uintptr_t)c->addr + (fidx * tpl_types[c->type].sz));
                         memcpy(caddr,dv,tpl_types[c->type].sz);
@@ -2024,7 +2126,7 @@ TPL_API int tpl_unpack(tpl_node *r, int i) {
                 break;
             case TPL_TYPE_BIN:
                 memcpy(&slen,dv,sizeof(uint32_t));
-                if (((tpl_root_data*)(r->data))->flags & TPL_XENDIAN)
+                if (xendian)
                     tpl_byteswap(&slen, sizeof(uint32_t));
                 if (slen > 0) {
                     str = (char*)tpl_hook.malloc(slen);
@@ -2039,7 +2141,7 @@ TPL_API int tpl_unpack(tpl_node *r, int i) {
             case TPL_TYPE_STR:
                 for(fidx=0; fidx < c->num; fidx++) {
                   memcpy(&slen,dv,sizeof(uint32_t));
-                  if (((tpl_root_data*)(r->data))->flags & TPL_XENDIAN)
+                  if (xendian)
                       tpl_byteswap(&slen, sizeof(uint32_t));
                   if (((tpl_root_data*)(r->data))->flags & TPL_OLD_STRING_FMT)
                     slen += 1;
@@ -2081,7 +2183,7 @@ TPL_API int tpl_unpack(tpl_node *r, int i) {
                 if (tpl_serlen(r,c,dv, &A_bytes) == -1)
                     tpl_hook.fatal("internal error in unpack\n");
                 memcpy( &((tpl_atyp*)(c->data))->num, dv, sizeof(uint32_t));
-                if (((tpl_root_data*)(r->data))->flags & TPL_XENDIAN)
+                if (xendian)
                     tpl_byteswap(&((tpl_atyp*)(c->data))->num, sizeof(uint32_t));
                 ((tpl_atyp*)(c->data))->cur = (void*)((uintptr_t)dv+sizeof(uint32_t));
                 dv = (void*)((uintptr_t)dv + A_bytes);
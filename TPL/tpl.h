@@ -66,6 +66,7 @@ extern "C" {
 #define TPL_DATAPEEK  (1 << 6)  
 #define TPL_FXLENS    (1 << 7)  
 #define TPL_GETSIZE   (1 << 8)
+#define TPL_TRUSTED   (1 << 9)  /* tpl_load: revalidate only the cached preamble */
 /* do not add flags here without renumbering the internal flags! */
 
 /* flags for tpl_gather mode */
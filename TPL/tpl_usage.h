@@ -161,4 +161,89 @@ int tpl_decode_array(const void* buf, size_t size, wifi_softap_info_t* out_infos
 cleanup:
     if (tn) tpl_free(tn);
     return ret;
-}
\ No newline at end of file
+}
+/* ---------- tpl trusted same-host decode ---------- */
+/*
+ * For peers running the same build on the same architecture, e.g. the
+ * high-rate intra-datacenter links. The decode map is built once and kept,
+ * and images are loaded with TPL_TRUSTED: the first image is fully checked
+ * by tpl_sanity, later ones only compare their preamble with the cached one
+ * and unpack without any endian swap. Encoding is the plain tpl_encode.
+ * The data size is still checked against the format (and the A() count) on
+ * every load, so a truncated or resized image is refused. That check is what
+ * keeps the process alive: tpl's fatal hook exit()s on data it can not walk.
+ * A corrupted image of the right size decodes to wrong field values, not to
+ * an error; the frame CRC32C is the integrity check.
+ */
+static wifi_softap_info_t tpl_trusted_tmp;
+static tpl_node* tpl_trusted_tn = NULL;
+static tpl_node* tpl_trusted_array_tn = NULL;
+
+/*
+ * tpl_decode_trusted
+ *  - input: buffer, size
+ *  - output: out_info (filled)
+ *  - return: 0 on success, -1 on failure
+ */
+int tpl_decode_trusted(void* buffer, size_t size, wifi_softap_info_t* out_info) {
+    if (!buffer || size == 0 || !out_info) return -1;
+
+    if (!tpl_trusted_tn) {
+        tpl_trusted_tn = tpl_map("S(ii$(c#c#)c#c#icv)", &tpl_trusted_tmp,
+                                 (int)sizeof(tpl_trusted_tmp.ip_address.ipv4),
+                                 (int)sizeof(tpl_trusted_tmp.ip_address.ipv6),
+                                 (int)sizeof(tpl_trusted_tmp.ssid),
+                                 (int)sizeof(tpl_trusted_tmp.bssid));
+        if (!tpl_trusted_tn) {
+            fprintf(stderr, "tpl_map failed\n");
+            return -1;
+        }
+    }
+
+    if (tpl_load(tpl_trusted_tn, TPL_MEM | TPL_TRUSTED, buffer, size) != 0) {
+        return -1;
+    }
+
+    if (tpl_unpack(tpl_trusted_tn, 0) != 1) {
+        return -1;
+    }
+
+    memcpy(out_info, &tpl_trusted_tmp, sizeof(wifi_softap_info_t));
+    return 0;
+}
+
+int tpl_decode_array_trusted(const void* buf, size_t size, wifi_softap_info_t* out_infos, int* out_count) {
+    if (!buf || size == 0 || !out_infos || !out_count) return -1;
+
+    if (!tpl_trusted_array_tn) {
+        tpl_trusted_array_tn = tpl_map("A(S(ii$(c#c#)c#c#icv))", &tpl_trusted_tmp,
+                                       sizeof(tpl_trusted_tmp.ip_address.ipv4),
+                                       sizeof(tpl_trusted_tmp.ip_address.ipv6),
+                                       sizeof(tpl_trusted_tmp.ssid),
+                                       sizeof(tpl_trusted_tmp.bssid));
+        if (!tpl_trusted_array_tn) {
+            fprintf(stderr, "tpl_map failed\n");
+            return -1;
+        }
+    }
+
+    if (tpl_load(tpl_trusted_array_tn, TPL_MEM | TPL_TRUSTED, buf, size) != 0) {
+        fprintf(stderr, "tpl_load failed\n");
+        return -1;
+    }
+
+    int count = tpl_Alen(tpl_trusted_array_tn, 1);
+    if (count <= 0 || count > MAX_ARRAY) {
+        fprintf(stderr, "invalid array length %d\n", count);
+        return -1;
+    }
+
+    int i = 0;
+    while (i < count && tpl_unpack(tpl_trusted_array_tn, 1) > 0) {
+        memcpy(out_infos + i, &tpl_trusted_tmp, sizeof(wifi_softap_info_t));
+        i++;
+    }
+
+    *out_count = i;
+    return 0;
+}
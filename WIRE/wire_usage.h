@@ -0,0 +1,101 @@
+/* WIRE/wire_usage.h
+ *
+ * Requires: nothing (in-tree, no library)
+ * Exports (static inline, byte helpers of the in-tree formats):
+ *   uint8_t *wire_put_varint(uint8_t *p, uint32_t value);
+ *   const uint8_t *wire_get_varint(const uint8_t *p, const uint8_t *end, int max_bytes, uint32_t *out);
+ *   uint32_t wire_zigzag32(int32_t value);
+ *   int32_t wire_unzigzag32(uint32_t value);
+ *   uint8_t *wire_put_le16(uint8_t *p, uint16_t value);
+ *   uint16_t wire_get_le16(const uint8_t *p);
+ *   uint8_t *wire_put_le32(uint8_t *p, uint32_t value);
+ *   uint32_t wire_get_le32(const uint8_t *p);
+ *
+ * Notes:
+ * - Varints are LEB128 as in protobuf: 7 bits per byte, low group first,
+ *   the high bit set on every byte but the last. A uint32_t takes up to
+ *   WIRE_VARINT32_MAX, a uint16_t up to WIRE_VARINT16_MAX.
+ * - Zigzag maps 0, -1, 1, -2 ... to 0, 1, 2, 3 ..., so a small signed value
+ *   (a difference) is a short varint.
+ * - Fixed-width integers are little-endian whatever the host.
+ * - Used by column, compact, delta and flat. Only wire_get_varint checks the
+ *   end of the buffer, the callers check the room for the others.
+ */
+
+#ifndef WIRE_USAGE_H
+#define WIRE_USAGE_H
+
+#include <stddef.h>
+#include <stdint.h>
+#include <string.h>
+
+#define WIRE_VARINT32_MAX 5
+#define WIRE_VARINT16_MAX 3
+
+static inline uint8_t* wire_put_varint(uint8_t* p, uint32_t value) {
+    while (value >= 0x80) {
+        *p++ = (uint8_t)(value | 0x80);
+        value >>= 7;
+    }
+    *p++ = (uint8_t)value;
+    return p;
+}
+
+/* NULL if the varint runs past end or is longer than max_bytes */
+static inline const uint8_t* wire_get_varint(const uint8_t* p, const uint8_t* end, int max_bytes, uint32_t* out) {
+    uint32_t value = 0;
+    for (int i = 0; i < max_bytes && p < end; i++) {
+        uint8_t byte = *p++;
+        value |= (uint32_t)(byte & 0x7F) << (7 * i);
+        if (!(byte & 0x80)) {
+            *out = value;
+            return p;
+        }
+    }
+    return NULL;
+}
+
+static inline uint32_t wire_zigzag32(int32_t value) {
+    return ((uint32_t)value << 1) ^ (uint32_t)(value >> 31);
+}
+
+static inline int32_t wire_unzigzag32(uint32_t value) {
+    return (int32_t)((value >> 1) ^ (0u - (value & 1)));
+}
+
+/* memcpy and a swap on big-endian hosts: one load / store on little-endian ones */
+static inline uint8_t* wire_put_le16(uint8_t* p, uint16_t value) {
+#if defined(__BYTE_ORDER__) && __BYTE_ORDER__ == __ORDER_BIG_ENDIAN__
+    value = __builtin_bswap16(value);
+#endif
+    memcpy(p, &value, sizeof(value));
+    return p + 2;
+}
+
+static inline uint16_t wire_get_le16(const uint8_t* p) {
+    uint16_t value;
+    memcpy(&value, p, sizeof(value));
+#if defined(__BYTE_ORDER__) && __BYTE_ORDER__ == __ORDER_BIG_ENDIAN__
+    value = __builtin_bswap16(value);
+#endif
+    return value;
+}
+
+static inline uint8_t* wire_put_le32(uint8_t* p, uint32_t value) {
+#if defined(__BYTE_ORDER__) && __BYTE_ORDER__ == __ORDER_BIG_ENDIAN__
+    value = __builtin_bswap32(value);
+#endif
+    memcpy(p, &value, sizeof(value));
+    return p + 4;
+}
+
+static inline uint32_t wire_get_le32(const uint8_t* p) {
+    uint32_t value;
+    memcpy(&value, p, sizeof(value));
+#if defined(__BYTE_ORDER__) && __BYTE_ORDER__ == __ORDER_BIG_ENDIAN__
+    value = __builtin_bswap32(value);
+#endif
+    return value;
+}
+
+#endif /* WIRE_USAGE_H */
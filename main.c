@@ -1,8 +1,13 @@
 #include <math.h>
 #include <time.h>
 
+#include "COLUMN/column_usage.h"
+#include "COMPACT/compact_usage.h"
+#include "DELTA/delta_usage.h"
+#include "FLAT/flat_usage.h"
 #include "MPACK/mpack_usage.h"
 #include "NANOPB/nanopb_usage.h"
+#include "RAW/raw_usage.h"
 #include "TPL/tpl_usage.h"
 
 int SHOW_STRUCTURE = 0;
@@ -13,8 +18,23 @@ size_t buffer_size = 0;
 static void print_usage(int argc, char** argv) {
     if (argc >= 4) {
         if (strcmp(argv[2], "tpl") == 0 ||
+            strcmp(argv[2], "tpl_trusted") == 0 ||
             strcmp(argv[2], "mpack") == 0 ||
-            strcmp(argv[2], "nanopb") == 0) {
+            strcmp(argv[2], "mpack_node") == 0 ||
+            strcmp(argv[2], "mpack_map") == 0 ||
+            strcmp(argv[2], "nanopb") == 0 ||
+            strcmp(argv[2], "nanopb_fast") == 0 ||
+            strcmp(argv[2], "nanopb_direct") == 0 ||
+            strcmp(argv[2], "nanopb_stream") == 0 ||
+            strcmp(argv[2], "nanopb_reuse") == 0 ||
+            strcmp(argv[2], "nanopb_view") == 0 ||
+            strcmp(argv[2], "flat") == 0 ||
+            strcmp(argv[2], "raw") == 0 ||
+            strcmp(argv[2], "column") == 0 ||
+            strcmp(argv[2], "compact") == 0 ||
+            strcmp(argv[2], "delta") == 0 ||
+            strcmp(argv[2], "mpack_dict") == 0 ||
+            strcmp(argv[2], "flat_dict") == 0) {
             if (strcmp(argv[3], "server") == 0) {
                 fprintf(stderr, "usage: %s %s %s server PORT\n", argv[0], argv[1], argv[2]);
                 return;
@@ -25,7 +45,7 @@ static void print_usage(int argc, char** argv) {
         }
     }
 
-    fprintf(stderr, "usage: %s SHOW_STRUCTURE(0/1) <tpl | mpack | nanopb> <benchmark_test [TEST_NUMBER]|no_socket|array_test [NUMBER 1-%d]|server PORT|client HOST PORT>\n", argv[0], MAX_ARRAY);
+    fprintf(stderr, "usage: %s SHOW_STRUCTURE(0/1) <tpl | tpl_trusted | mpack | mpack_node | mpack_map | nanopb | nanopb_fast | nanopb_direct | nanopb_stream | nanopb_reuse | nanopb_view | flat | raw | column | compact | delta | mpack_dict | flat_dict> <benchmark_test [TEST_NUMBER]|codec_benchmark [TEST_NUMBER]|conformance_test [TEST_NUMBER]|no_socket|array_test [NUMBER 1-%d]|server PORT|client HOST PORT>\n", argv[0], MAX_ARRAY);
 }
 
 /* High-resolution wall-clock time in nanoseconds (uses CLOCK_MONOTONIC) */
@@ -82,26 +102,73 @@ double calculateStdDev(double* arr, int n) {
     return sqrt(sumsq / (double)(n - 1));
 }
 
+/* adapters for the table below: the same call, the table's signature */
+static int codec_tpl_encode(const wifi_softap_info_t* info, void* out_buffer, size_t* out_size) {
+    return tpl_encode((wifi_softap_info_t*)info, out_buffer, out_size); /* info is only read */
+}
+static int codec_tpl_decode_array(void* buf, size_t sz, wifi_softap_info_t* out_infos, int* out_count) {
+    return tpl_decode_array(buf, sz, out_infos, out_count);
+}
+static int codec_tpl_decode_array_trusted(void* buf, size_t sz, wifi_softap_info_t* out_infos, int* out_count) {
+    return tpl_decode_array_trusted(buf, sz, out_infos, out_count);
+}
+static int codec_mpack_encode(const wifi_softap_info_t* info, void* out_buffer, size_t* out_size) {
+    return mpack_encode((wifi_softap_info_t*)info, out_buffer, out_size); /* info is only read */
+}
+static int codec_mpack_encode_map(const wifi_softap_info_t* info, void* out_buffer, size_t* out_size) {
+    return mpack_encode_map((wifi_softap_info_t*)info, out_buffer, out_size); /* info is only read */
+}
+static int codec_flat_encode_dict(const wifi_softap_info_t* info, void* out_buffer, size_t* out_size) {
+    return flat_encode_array_dict(info, 1, out_buffer, out_size);
+}
+
+/* the encode / decode functions of one library */
+typedef struct {
+    const char* name;
+    int (*encode)(const wifi_softap_info_t* info, void* out_buffer, size_t* out_size);
+    int (*decode)(void* buf, size_t sz, wifi_softap_info_t* out_info);
+    int (*encode_array)(const wifi_softap_info_t* infos, int count, void* out_buffer, size_t* out_size);
+    int (*decode_array)(void* buf, size_t sz, wifi_softap_info_t* out_infos, int* out_count);
+} codec_t;
+
+static const codec_t codecs[] = {
+    {"tpl", codec_tpl_encode, tpl_decode, tpl_encode_array, codec_tpl_decode_array},
+    {"tpl_trusted", codec_tpl_encode, tpl_decode_trusted, tpl_encode_array, codec_tpl_decode_array_trusted},
+    {"mpack", codec_mpack_encode, mpack_decode, mpack_encode_array, mpack_decode_array},
+    {"mpack_node", codec_mpack_encode, mpack_decode_node, mpack_encode_array, mpack_decode_array_node},
+    {"mpack_map", codec_mpack_encode_map, mpack_decode_map, mpack_encode_array_map, mpack_decode_array_map},
+    {"nanopb", nanopb_encode, nanopb_decode, nanopb_encode_array, nanopb_decode_array},
+    {"nanopb_fast", nanopb_fast_encode, nanopb_fast_decode, nanopb_fast_encode_array, nanopb_fast_decode_array},
+    {"nanopb_direct", nanopb_direct_encode, nanopb_direct_decode, nanopb_direct_encode_array, nanopb_direct_decode_array},
+    {"nanopb_stream", nanopb_direct_encode, nanopb_direct_decode, nanopb_stream_encode_array, nanopb_stream_decode_array},
+    {"nanopb_reuse", nanopb_encode, nanopb_reuse_decode, nanopb_encode_array, nanopb_reuse_decode_array},
+    {"nanopb_view", nanopb_encode, nanopb_view_decode, nanopb_encode_array, nanopb_view_decode_array},
+    {"flat", flat_encode, flat_decode, flat_encode_array, flat_decode_array},
+    {"raw", raw_encode, raw_decode, raw_encode_array, raw_decode_array},
+    {"column", column_encode, column_decode, column_encode_array, column_decode_array},
+    {"compact", compact_encode, compact_decode, compact_encode_array, compact_decode_array},
+    {"delta", delta_encode, delta_decode, delta_encode_array, delta_decode_array},
+    {"mpack_dict", mpack_encode_dict, mpack_decode_dict, mpack_encode_array_dict, mpack_decode_array_dict},
+    {"flat_dict", codec_flat_encode_dict, flat_decode, flat_encode_array_dict, flat_decode_array},
+};
+
+/* the codecs[] entry of library, or NULL */
+static const codec_t* codec_lookup(const char* library) {
+    for (size_t i = 0; i < sizeof(codecs) / sizeof(codecs[0]); i++) {
+        if (strcmp(library, codecs[i].name) == 0) return &codecs[i];
+    }
+    fprintf(stderr, "unsupported library: %s\n", library);
+    return NULL;
+}
+
 /* encode the wifi_softap_info_t struct
- * library: "tpl", "mpack", "nanopb"
+ * library: a codecs[] name
  * out_buffer, out_size: output buffer and size
  * returns 0 on success
  */
 static int encode(char* library, wifi_softap_info_t* info, void* out_buffer, size_t* out_size) {
-    if (strcmp(library, "tpl") == 0) {
-        if (tpl_encode(info, out_buffer, out_size) != 0) {
-            return -1;
-        }
-    } else if (strcmp(library, "mpack") == 0) {
-        if (mpack_encode(info, out_buffer, out_size) != 0) {
-            return -1;
-        }
-    } else if (strcmp(library, "nanopb") == 0) {
-        if (nanopb_encode(info, out_buffer, out_size) != 0) {
-            return -1;
-        }
-    } else {
-        fprintf(stderr, "unsupported library: %s\n", library);
+    const codec_t* codec = codec_lookup(library);
+    if (!codec || codec->encode(info, out_buffer, out_size) != 0) {
         return -1;
     }
 
@@ -117,53 +184,29 @@ static int encode(char* library, wifi_softap_info_t* info, void* out_buffer, siz
 }
 
 /* decode the wifi_softap_info_t struct
- * library: "tpl", "mpack", "nanopb"
+ * library: a codecs[] name
  * buf, sz: input buffer and size
  * out_info: output struct
  * returns 0 on success
  */
 static int decode(char* library, void* buf, size_t sz, wifi_softap_info_t* out_info) {
-    if (strcmp(library, "tpl") == 0) {
-        if (tpl_decode(buf, sz, out_info) != 0) {
-            return -1;
-        }
-    } else if (strcmp(library, "mpack") == 0) {
-        if (mpack_decode(buf, sz, out_info) != 0) {
-            return -1;
-        }
-    } else if (strcmp(library, "nanopb") == 0) {
-        if (nanopb_decode(buf, sz, out_info) != 0) {
-            return -1;
-        }
-    } else {
-        fprintf(stderr, "unsupported library: %s\n", library);
+    const codec_t* codec = codec_lookup(library);
+    if (!codec || codec->decode(buf, sz, out_info) != 0) {
         return -1;
     }
     return 0;
 }
 
 /* encode array of wifi_softap_info_t structs
- * library: "tpl", "mpack", "nanopb"
+ * library: a codecs[] name
  * infos: input array of structs
  * count: number of structs
  * out_buffer, out_size: output buffer and size
  * returns 0 on success
  */
 static int encode_array(char* library, const wifi_softap_info_t* infos, int count, void* out_buffer, size_t* out_size) {
-    if (strcmp(library, "tpl") == 0) {
-        if (tpl_encode_array(infos, count, out_buffer, out_size) != 0) {
-            return -1;
-        }
-    } else if (strcmp(library, "mpack") == 0) {
-        if (mpack_encode_array(infos, count, out_buffer, out_size) != 0) {
-            return -1;
-        }
-    } else if (strcmp(library, "nanopb") == 0) {
-        if (nanopb_encode_array(infos, count, out_buffer, out_size) != 0) {
-            return -1;
-        }
-    } else {
-        fprintf(stderr, "unsupported library: %s\n", library);
+    const codec_t* codec = codec_lookup(library);
+    if (!codec || codec->encode_array(infos, count, out_buffer, out_size) != 0) {
         return -1;
     }
 
@@ -180,27 +223,15 @@ static int encode_array(char* library, const wifi_softap_info_t* infos, int coun
 }
 
 /* decode array of wifi_softap_info_t structs
- * library: "tpl", "mpack", "nanopb"
+ * library: a codecs[] name
  * buf, sz: input buffer and size
  * out_infos: output array of structs
  * out_count: number of structs decoded
  * returns 0 on success
  */
 static int decode_array(char* library, void* buf, size_t sz, wifi_softap_info_t* out_infos, int* out_count) {
-    if (strcmp(library, "tpl") == 0) {
-        if (tpl_decode_array(buf, sz, out_infos, out_count) != 0) {
-            return -1;
-        }
-    } else if (strcmp(library, "mpack") == 0) {
-        if (mpack_decode_array(buf, sz, out_infos, out_count) != 0) {
-            return -1;
-        }
-    } else if (strcmp(library, "nanopb") == 0) {
-        if (nanopb_decode_array(buf, sz, out_infos, out_count) != 0) {
-            return -1;
-        }
-    } else {
-        fprintf(stderr, "unsupported library: %s\n", library);
+    const codec_t* codec = codec_lookup(library);
+    if (!codec || codec->decode_array(buf, sz, out_infos, out_count) != 0) {
         return -1;
     }
     return 0;
@@ -263,6 +294,503 @@ int do_array_no_socket_test(char* library, wifi_softap_info_t* infos, int array_
     return 0;
 }
 
+/*
+ * do_codec_benchmark
+ *  - times encode and decode separately, each as one batch of test_number
+ *    calls on a single timer, so per-call clock overhead and the buffer
+ *    memset of the round-trip tests are not included
+ *  - the codec is looked up once, the loops call its functions directly:
+ *    array_size 1 its encode/decode, larger sizes encode_array/decode_array
+ *  - output: mean ns per encode / decode call
+ *  - returns 0 on success
+ */
+int do_codec_benchmark(char* library, wifi_softap_info_t* infos, int array_size, int test_number, double* encode_ns, double* decode_ns) {
+    wifi_softap_info_t decoded_infos[MAX_ARRAY];
+    int count = 0;
+    int rc = 0;
+
+    if (array_size <= 0 || array_size > MAX_ARRAY || test_number <= 0) return -1;
+    const codec_t* codec = codec_lookup(library);
+    if (!codec) return -1;
+
+    double start = now_ns();
+    if (array_size == 1) {
+        for (int i = 0; i < test_number && rc == 0; i++) rc = codec->encode(infos, bytes_buffer, &buffer_size);
+    } else {
+        for (int i = 0; i < test_number && rc == 0; i++) {
+            rc = codec->encode_array(infos, array_size, bytes_buffer, &buffer_size);
+        }
+    }
+    *encode_ns = (now_ns() - start) / test_number;
+    if (rc != 0) {
+        fprintf(stderr, "encode failed\n");
+        return -1;
+    }
+
+    start = now_ns();
+    if (array_size == 1) {
+        for (int i = 0; i < test_number && rc == 0; i++) rc = codec->decode(bytes_buffer, buffer_size, decoded_infos);
+    } else {
+        for (int i = 0; i < test_number && rc == 0; i++) {
+            rc = codec->decode_array(bytes_buffer, buffer_size, decoded_infos, &count);
+        }
+    }
+    *decode_ns = (now_ns() - start) / test_number;
+    if (rc != 0) {
+        fprintf(stderr, "decode failed\n");
+        return -1;
+    }
+    return 0;
+}
+
+/*
+ * do_lz_benchmark
+ *  - compresses the size bytes at buffer, then decompresses the block, each
+ *    test_number times on a single timer, as the frame layer would for a
+ *    payload of this codec; the round trip must give the input back
+ *  - output: compressed size, MB/s of input compressed / output decompressed
+ *  - returns 0 on success
+ */
+int do_lz_benchmark(const uint8_t* buffer, size_t size, int test_number, size_t* packed_size, double* compress_mbs, double* decompress_mbs) {
+    static uint8_t packed[LZ_COMPRESS_BOUND(MAX_BUFFER)];
+    static uint8_t plain[MAX_BUFFER];
+    size_t plain_size = 0;
+    int rc = 0;
+
+    if (size == 0 || size > MAX_BUFFER || test_number <= 0) return -1;
+
+    double start = now_ns();
+    for (int i = 0; i < test_number && rc == 0; i++) {
+        rc = lz_compress(buffer, size, packed, sizeof(packed), packed_size);
+    }
+    double compress_ns = (now_ns() - start) / test_number;
+
+    start = now_ns();
+    for (int i = 0; i < test_number && rc == 0; i++) {
+        rc = lz_decompress(packed, *packed_size, plain, sizeof(plain), &plain_size);
+    }
+    double decompress_ns = (now_ns() - start) / test_number;
+
+    if (rc != 0 || plain_size != size || memcmp(plain, buffer, size) != 0) {
+        fprintf(stderr, "lz round trip failed\n");
+        return -1;
+    }
+    /* bytes per ns * 1000 = MB/s */
+    *compress_mbs = size / compress_ns * 1e3;
+    *decompress_mbs = size / decompress_ns * 1e3;
+    return 0;
+}
+
+/*
+ * do_crc_benchmark
+ *  - checksums the size bytes at buffer test_number times on a single timer
+ *    with crc32c_hw and with crc32c_sw, as the frame layer would for one
+ *    payload; both must give the same value, and the check value
+ *    0xE3069283 for "123456789" first
+ *  - output: mean ns per checksum of each
+ *  - returns 0 on success
+ */
+int do_crc_benchmark(const uint8_t* buffer, size_t size, int test_number, double* hw_ns, double* sw_ns) {
+    /* volatile: the result of every call is kept, none is optimized away */
+    volatile uint32_t hw_crc = 0, sw_crc = 0;
+
+    if (size == 0 || test_number <= 0) return -1;
+
+    if (crc32c_hw(0, "123456789", 9) != 0xE3069283 || crc32c_sw(0, "123456789", 9) != 0xE3069283) {
+        fprintf(stderr, "crc32c check value: 0x%08x hw, 0x%08x sw, expected 0xe3069283\n",
+                crc32c_hw(0, "123456789", 9), crc32c_sw(0, "123456789", 9));
+        return -1;
+    }
+
+    double start = now_ns();
+    for (int i = 0; i < test_number; i++) hw_crc = crc32c_hw(0, buffer, size);
+    *hw_ns = (now_ns() - start) / test_number;
+
+    start = now_ns();
+    for (int i = 0; i < test_number; i++) sw_crc = crc32c_sw(0, buffer, size);
+    *sw_ns = (now_ns() - start) / test_number;
+
+    if (hw_crc != sw_crc) {
+        fprintf(stderr, "crc32c mismatch: 0x%08x hw, 0x%08x sw\n", hw_crc, sw_crc);
+        return -1;
+    }
+    return 0;
+}
+
+/* fills info with random field values, ssid of 0-WIFI_SSID_MAX_LEN chars */
+static void getRandomSampleData(wifi_softap_info_t* info) {
+    memset(info, 0, sizeof(*info));
+    info->device_count = (rand() % 4 == 0) ? 0 : rand() - RAND_MAX / 2;
+    info->state = (wifi_softap_state_t)(rand() % 3);
+    for (int i = 0; i < IPV4_LEN; i++) info->ip_address.ipv4[i] = (uint8_t)rand();
+    for (int i = 0; i < IPV6_LEN; i++) info->ip_address.ipv6[i] = (rand() % 2) ? (uint8_t)rand() : 0;
+    int sslen = rand() % (WIFI_SSID_MAX_LEN + 1);
+    for (int i = 0; i < sslen; i++) info->ssid[i] = (char)(' ' + rand() % 95);
+    for (int i = 0; i < WIFI_BT_MAC_ADDRESS_LEN; i++) info->bssid[i] = (uint8_t)rand();
+    info->security = (security_type_t)(rand() % 3);
+    info->channel = (uint8_t)rand();
+    info->frequency = (uint16_t)rand();
+}
+
+static int softap_info_equal(const wifi_softap_info_t* a, const wifi_softap_info_t* b) {
+    return a->device_count == b->device_count && a->state == b->state &&
+           memcmp(&a->ip_address, &b->ip_address, sizeof(a->ip_address)) == 0 &&
+           strcmp(a->ssid, b->ssid) == 0 && memcmp(a->bssid, b->bssid, sizeof(a->bssid)) == 0 &&
+           a->security == b->security && a->channel == b->channel && a->frequency == b->frequency;
+}
+
+/* the codec a library variant must stay wire-compatible with, or NULL */
+static char* reference_library(const char* library) {
+    if (strcmp(library, "tpl_trusted") == 0) return "tpl";
+    if (strcmp(library, "mpack_node") == 0) return "mpack";
+    if (strcmp(library, "nanopb_fast") == 0) return "nanopb";
+    if (strcmp(library, "nanopb_direct") == 0) return "nanopb";
+    if (strcmp(library, "nanopb_stream") == 0) return "nanopb";
+    if (strcmp(library, "nanopb_reuse") == 0) return "nanopb";
+    if (strcmp(library, "nanopb_view") == 0) return "nanopb";
+    return NULL;
+}
+
+/*
+ * do_conformance_test
+ *  - random records, 1 to MAX_ARRAY per message: library and reference must
+ *    produce the same bytes, and each must decode the other's output back
+ *    to the input
+ *  - reference NULL: library must decode its own output back to the input
+ *  - returns 0 on success
+ */
+int do_conformance_test(char* library, char* reference, int test_number) {
+    static uint8_t ref_buffer[MAX_BUFFER];
+    wifi_softap_info_t infos[MAX_ARRAY];
+    wifi_softap_info_t decoded_infos[MAX_ARRAY];
+    size_t ref_size = 0;
+    int count = 0;
+
+    srand(1);
+    for (int t = 0; t < test_number; t++) {
+        int array_size = 1 + t % MAX_ARRAY;
+        for (int i = 0; i < array_size; i++) getRandomSampleData(&infos[i]);
+
+        if (array_size == 1) {
+            if (encode(library, infos, bytes_buffer, &buffer_size) != 0 ||
+                (reference && encode(reference, infos, ref_buffer, &ref_size) != 0)) {
+                fprintf(stderr, "conformance: encode failed in test %d\n", t);
+                return -1;
+            }
+        } else {
+            if (encode_array(library, infos, array_size, bytes_buffer, &buffer_size) != 0 ||
+                (reference && encode_array(reference, infos, array_size, ref_buffer, &ref_size) != 0)) {
+                fprintf(stderr, "conformance: encode failed in test %d\n", t);
+                return -1;
+            }
+        }
+        if (!reference) {
+            memcpy(ref_buffer, bytes_buffer, buffer_size);
+            ref_size = buffer_size;
+        } else if (buffer_size != ref_size || memcmp(bytes_buffer, ref_buffer, ref_size) != 0) {
+            fprintf(stderr, "conformance: %s and %s bytes differ in test %d\n", library, reference, t);
+            return -1;
+        }
+
+        /* cross decode: library reads the reference bytes and vice versa */
+        char* decoders[2] = {library, reference};
+        for (int d = 0; d < (reference ? 2 : 1); d++) {
+            uint8_t* input = d == 0 ? ref_buffer : bytes_buffer;
+            int rc;
+            memset(decoded_infos, 0, sizeof(decoded_infos));
+            if (array_size == 1) {
+                rc = decode(decoders[d], input, ref_size, decoded_infos);
+                count = 1;
+            } else {
+                rc = decode_array(decoders[d], input, ref_size, decoded_infos, &count);
+            }
+            if (rc != 0 || count != array_size) {
+                fprintf(stderr, "conformance: %s decode failed in test %d\n", decoders[d], t);
+                return -1;
+            }
+            for (int i = 0; i < array_size; i++) {
+                if (!softap_info_equal(&infos[i], &decoded_infos[i])) {
+                    fprintf(stderr, "conformance: %s record %d differs in test %d\n", decoders[d], i, t);
+                    return -1;
+                }
+            }
+        }
+    }
+    return 0;
+}
+
+/* the next snapshot of a stream: each device_count moves by +-1 with 1/4 chance */
+static void next_delta_snapshot(wifi_softap_info_t* infos, int count) {
+    for (int i = 0; i < count; i++) {
+        if (rand() % 4 == 0) infos[i].device_count += (rand() % 2) ? 1 : -1;
+    }
+}
+
+/*
+ * do_delta_stream_test
+ *  - one delta sender and receiver over test_number snapshots of MAX_ARRAY
+ *    random APs, every message decoded must give the snapshot back
+ *  - every 97th snapshot one AP is replaced by a new BSSID
+ *  - every 50th message is dropped, and every 200th names a table slot the
+ *    receiver does not use: the receiver must reject the next delta, and
+ *    decode again after delta_request_keyframe()
+ *  - output: messages the receiver rejected
+ *  - returns 0 on success
+ */
+int do_delta_stream_test(int test_number, int* rejected) {
+    static delta_state_t sender, receiver;
+    wifi_softap_info_t infos[MAX_ARRAY];
+    wifi_softap_info_t decoded_infos[MAX_ARRAY];
+    int count = 0;
+    int out_of_sync = 0;
+
+    srand(2);
+    for (int i = 0; i < MAX_ARRAY; i++) getRandomSampleData(&infos[i]);
+    delta_init(&sender);
+    delta_init(&receiver);
+    *rejected = 0;
+
+    for (int t = 0; t < test_number; t++) {
+        next_delta_snapshot(infos, MAX_ARRAY);
+        if (t % 97 == 96) getRandomSampleData(&infos[rand() % MAX_ARRAY]);
+        if (delta_encode_snapshot(&sender, infos, MAX_ARRAY, bytes_buffer, MAX_BUFFER, &buffer_size) != 0) {
+            fprintf(stderr, "delta stream: encode failed in message %d\n", t);
+            return -1;
+        }
+        int keyframe = bytes_buffer[3] & DELTA_KEYFRAME;
+        if (t % 50 == 49) {
+            out_of_sync = 1; /* dropped */
+            continue;
+        }
+        int unknown_slot = t % 200 == 120 && !keyframe;
+        if (unknown_slot) {
+            /* first record key, after the header and the 1-byte count */
+            int slot = 0;
+            while (slot < DELTA_TABLE_SIZE && receiver.slots[slot].used) slot++;
+            bytes_buffer[DELTA_HEADER_SIZE + 1] = (uint8_t)slot;
+        }
+
+        int rc = delta_decode_snapshot(&receiver, bytes_buffer, buffer_size, decoded_infos, MAX_ARRAY, &count);
+        if ((out_of_sync || unknown_slot) && !keyframe) {
+            if (rc == 0) {
+                fprintf(stderr, "delta stream: message %d applied out of sync\n", t);
+                return -1;
+            }
+            delta_request_keyframe(&sender);
+            (*rejected)++;
+            out_of_sync = 0;
+            continue;
+        }
+        if (rc != 0 || count != MAX_ARRAY) {
+            fprintf(stderr, "delta stream: decode failed in message %d\n", t);
+            return -1;
+        }
+        for (int i = 0; i < MAX_ARRAY; i++) {
+            if (!softap_info_equal(&infos[i], &decoded_infos[i])) {
+                fprintf(stderr, "delta stream: record %d differs in message %d\n", i, t);
+                return -1;
+            }
+        }
+        out_of_sync = 0;
+    }
+    return 0;
+}
+
+/*
+ * do_delta_stream_benchmark
+ *  - one delta sender and receiver over test_number snapshots of MAX_ARRAY
+ *    random APs, each device_count moving by +-1 with 1/4 chance per
+ *    snapshot; encode and decode are timed per batch of
+ *    DELTA_KEYFRAME_INTERVAL messages, the snapshot updates are not
+ *  - output: mean bytes per message and of a keyframe, mean ns per encode /
+ *    decode of a message
+ *  - returns 0 on success
+ */
+int do_delta_stream_benchmark(int test_number, double* message_bytes, double* keyframe_bytes, double* encode_ns,
+                              double* decode_ns) {
+    static delta_state_t sender, receiver;
+    static wifi_softap_info_t snapshots[DELTA_KEYFRAME_INTERVAL][MAX_ARRAY];
+    static uint8_t messages[DELTA_KEYFRAME_INTERVAL][MAX_BUFFER];
+    size_t sizes[DELTA_KEYFRAME_INTERVAL];
+    wifi_softap_info_t decoded_infos[MAX_ARRAY];
+    double total_bytes = 0.0, total_keyframe_bytes = 0.0, total_encode_ns = 0.0, total_decode_ns = 0.0;
+    int keyframes = 0, count = 0, rc = 0;
+
+    if (test_number <= 0) return -1;
+    srand(2);
+    for (int i = 0; i < MAX_ARRAY; i++) getRandomSampleData(&snapshots[DELTA_KEYFRAME_INTERVAL - 1][i]);
+    delta_init(&sender);
+    delta_init(&receiver);
+
+    for (int done = 0; done < test_number; done += DELTA_KEYFRAME_INTERVAL) {
+        int batch = test_number - done < DELTA_KEYFRAME_INTERVAL ? test_number - done : DELTA_KEYFRAME_INTERVAL;
+        const wifi_softap_info_t* last = snapshots[DELTA_KEYFRAME_INTERVAL - 1];
+        for (int m = 0; m < batch; m++) {
+            memcpy(snapshots[m], last, sizeof(snapshots[m]));
+            next_delta_snapshot(snapshots[m], MAX_ARRAY);
+            last = snapshots[m];
+        }
+
+        double start = now_ns();
+        for (int m = 0; m < batch && rc == 0; m++) {
+            rc = delta_encode_snapshot(&sender, snapshots[m], MAX_ARRAY, messages[m], MAX_BUFFER, &sizes[m]);
+        }
+        total_encode_ns += now_ns() - start;
+
+        start = now_ns();
+        for (int m = 0; m < batch && rc == 0; m++) {
+            rc = delta_decode_snapshot(&receiver, messages[m], sizes[m], decoded_infos, MAX_ARRAY, &count);
+        }
+        total_decode_ns += now_ns() - start;
+        if (rc != 0) {
+            fprintf(stderr, "delta stream round trip failed\n");
+            return -1;
+        }
+
+        for (int m = 0; m < batch; m++) {
+            total_bytes += sizes[m];
+            if (messages[m][3] & DELTA_KEYFRAME) {
+                total_keyframe_bytes += sizes[m];
+                keyframes++;
+            }
+        }
+    }
+    *message_bytes = total_bytes / test_number;
+    *keyframe_bytes = total_keyframe_bytes / keyframes;
+    *encode_ns = total_encode_ns / test_number;
+    *decode_ns = total_decode_ns / test_number;
+    return 0;
+}
+
+/* records in one column batch test / benchmark, far above MAX_ARRAY */
+#define COLUMN_BATCH_RECORDS 5000
+/* per record: more than column_max_size() needs for any record */
+#define COLUMN_BATCH_BUFFER \
+    (COLUMN_HEADER_SIZE + COLUMN_BATCH_RECORDS * (sizeof(wifi_softap_info_t) + WIRE_VARINT32_MAX + WIRE_VARINT16_MAX))
+
+/* a record of a wifi scan: random addresses / ssid, device_count 0-7, 2.4GHz channel */
+static void getRandomScanData(wifi_softap_info_t* info) {
+    getRandomSampleData(info);
+    info->device_count = rand() % 8;
+    info->channel = (uint8_t)(1 + rand() % 13);
+    info->frequency = (uint16_t)(2407 + 5 * info->channel);
+}
+
+/* 1 if record i of batch holds info */
+static int column_batch_equal(const column_batch_t* batch, int i, const wifi_softap_info_t* info) {
+    size_t len = batch->ssid_offset[i + 1] - batch->ssid_offset[i];
+    return batch->device_count[i] == info->device_count && batch->state[i] == info->state &&
+           memcmp(batch->ipv4 + i * IPV4_LEN, info->ip_address.ipv4, IPV4_LEN) == 0 &&
+           memcmp(batch->ipv6 + i * IPV6_LEN, info->ip_address.ipv6, IPV6_LEN) == 0 &&
+           len == strlen(info->ssid) && memcmp(batch->ssid_blob + batch->ssid_offset[i], info->ssid, len) == 0 &&
+           memcmp(batch->bssid + i * WIFI_BT_MAC_ADDRESS_LEN, info->bssid, WIFI_BT_MAC_ADDRESS_LEN) == 0 &&
+           batch->security[i] == info->security && batch->channel[i] == info->channel &&
+           batch->frequency[i] == info->frequency;
+}
+
+/* column storage for column_decode_batch() of up to COLUMN_BATCH_RECORDS */
+static void column_batch_storage(column_batch_t* batch) {
+    static int32_t device_count[COLUMN_BATCH_RECORDS];
+    static uint8_t state[COLUMN_BATCH_RECORDS], security[COLUMN_BATCH_RECORDS];
+    static uint16_t frequency[COLUMN_BATCH_RECORDS];
+    static uint32_t ssid_offset[COLUMN_BATCH_RECORDS + 1];
+
+    memset(batch, 0, sizeof(*batch));
+    batch->capacity = COLUMN_BATCH_RECORDS;
+    batch->device_count = device_count;
+    batch->state = state;
+    batch->security = security;
+    batch->frequency = frequency;
+    batch->ssid_offset = ssid_offset;
+}
+
+/*
+ * do_column_batch_test
+ *  - test_number batches of random scan records, the first of
+ *    COLUMN_BATCH_RECORDS, the others of MAX_ARRAY + 1 to
+ *    COLUMN_BATCH_RECORDS: column_decode_records() and column_decode_batch()
+ *    must both give the input back
+ *  - returns 0 on success
+ */
+int do_column_batch_test(int test_number) {
+    static wifi_softap_info_t infos[COLUMN_BATCH_RECORDS];
+    static wifi_softap_info_t decoded_infos[COLUMN_BATCH_RECORDS];
+    static uint8_t buffer[COLUMN_BATCH_BUFFER];
+    column_batch_t batch;
+    size_t size = 0;
+    int count = 0;
+
+    srand(3);
+    column_batch_storage(&batch);
+    for (int t = 0; t < test_number; t++) {
+        int n = t == 0 ? COLUMN_BATCH_RECORDS : MAX_ARRAY + 1 + rand() % (COLUMN_BATCH_RECORDS - MAX_ARRAY);
+        for (int i = 0; i < n; i++) getRandomScanData(&infos[i]);
+
+        if (column_encode_records(infos, n, buffer, sizeof(buffer), &size) != 0) {
+            fprintf(stderr, "column batch: encode of %d records failed in test %d\n", n, t);
+            return -1;
+        }
+        if (column_decode_records(buffer, size, decoded_infos, COLUMN_BATCH_RECORDS, &count) != 0 || count != n) {
+            fprintf(stderr, "column batch: column_decode_records failed in test %d\n", t);
+            return -1;
+        }
+        if (column_decode_batch(buffer, size, &batch) != 0 || batch.count != n) {
+            fprintf(stderr, "column batch: column_decode_batch failed in test %d\n", t);
+            return -1;
+        }
+        for (int i = 0; i < n; i++) {
+            if (!softap_info_equal(&infos[i], &decoded_infos[i]) || !column_batch_equal(&batch, i, &infos[i])) {
+                fprintf(stderr, "column batch: record %d of %d differs in test %d\n", i, n, t);
+                return -1;
+            }
+        }
+    }
+    return 0;
+}
+
+/*
+ * do_column_batch_benchmark
+ *  - one batch of COLUMN_BATCH_RECORDS random scan records, encoded and
+ *    decoded test_number times with column_decode_records() and
+ *    column_decode_batch(), each on a single timer
+ *  - output: encoded bytes, mean ns per record of each
+ *  - returns 0 on success
+ */
+int do_column_batch_benchmark(int test_number, size_t* size, double* encode_ns, double* records_ns, double* batch_ns) {
+    static wifi_softap_info_t infos[COLUMN_BATCH_RECORDS];
+    static wifi_softap_info_t decoded_infos[COLUMN_BATCH_RECORDS];
+    static uint8_t buffer[COLUMN_BATCH_BUFFER];
+    column_batch_t batch;
+    int rc = 0, count = 0;
+
+    if (test_number <= 0) return -1;
+    srand(3);
+    for (int i = 0; i < COLUMN_BATCH_RECORDS; i++) getRandomScanData(&infos[i]);
+    column_batch_storage(&batch);
+
+    double start = now_ns();
+    for (int t = 0; t < test_number && rc == 0; t++) {
+        rc = column_encode_records(infos, COLUMN_BATCH_RECORDS, buffer, sizeof(buffer), size);
+    }
+    *encode_ns = (now_ns() - start) / test_number / COLUMN_BATCH_RECORDS;
+
+    start = now_ns();
+    for (int t = 0; t < test_number && rc == 0; t++) {
+        rc = column_decode_records(buffer, *size, decoded_infos, COLUMN_BATCH_RECORDS, &count);
+    }
+    *records_ns = (now_ns() - start) / test_number / COLUMN_BATCH_RECORDS;
+
+    start = now_ns();
+    for (int t = 0; t < test_number && rc == 0; t++) rc = column_decode_batch(buffer, *size, &batch);
+    *batch_ns = (now_ns() - start) / test_number / COLUMN_BATCH_RECORDS;
+
+    if (rc != 0 || count != COLUMN_BATCH_RECORDS || batch.count != COLUMN_BATCH_RECORDS) {
+        fprintf(stderr, "column batch round trip failed\n");
+        return -1;
+    }
+    return 0;
+}
+
 int main(int argc, char** argv) {
     int ret = -1;
     if (argc < 4) {
@@ -398,6 +926,132 @@ int main(int argc, char** argv) {
 
         ret = 0;
 
+    } else if (strcmp(argv[3], "codec_benchmark") == 0) {
+        int test_number = 100000;
+        if (argc >= 5) test_number = atoi(argv[4]);
+        if (test_number <= 0) {
+            print_usage(argc, argv);
+            goto done;
+        }
+
+        wifi_softap_info_t infos[MAX_ARRAY];
+        memset(infos, 0, sizeof(infos));
+        fulfillSampleData(infos, MAX_ARRAY);
+
+        double encode_ns = 0.0, decode_ns = 0.0;
+        SHOW_STRUCTURE = 0;
+
+        /* warm-up run (not recorded) */
+        if (do_codec_benchmark(argv[2], infos, MAX_ARRAY, test_number / 10 + 1, &encode_ns, &decode_ns) != 0) {
+            fprintf(stderr, "codec benchmark warmup failed\n");
+            goto done;
+        }
+
+        /* every size is also timed with "raw", the packed struct copy, and
+         * reported as a multiple of it: the distance to the floor */
+        int sizes[] = {1, 10, MAX_ARRAY};
+        for (size_t i = 0; i < sizeof(sizes) / sizeof(sizes[0]); i++) {
+            double raw_encode_ns = 0.0, raw_decode_ns = 0.0;
+            if (do_codec_benchmark("raw", infos, sizes[i], test_number, &raw_encode_ns, &raw_decode_ns) != 0 ||
+                do_codec_benchmark(argv[2], infos, sizes[i], test_number, &encode_ns, &decode_ns) != 0) {
+                fprintf(stderr, "codec benchmark failed\n");
+                goto done;
+            }
+            printf("%s %2d record(s) %5zu bytes: encode=%9.2f ns (%7.2f ns/record, %6.1fx raw), decode=%9.2f ns (%7.2f ns/record, %6.1fx raw)\n",
+                   argv[2], sizes[i], buffer_size, encode_ns, encode_ns / sizes[i], encode_ns / raw_encode_ns,
+                   decode_ns, decode_ns / sizes[i], decode_ns / raw_decode_ns);
+        }
+
+        /* the frame compression on the largest array of this codec */
+        size_t packed_size = 0;
+        double compress_mbs = 0.0, decompress_mbs = 0.0;
+        if (do_lz_benchmark(bytes_buffer, buffer_size, test_number, &packed_size, &compress_mbs, &decompress_mbs) != 0) {
+            fprintf(stderr, "lz benchmark failed\n");
+            goto done;
+        }
+        printf("%s %2d record(s) lz: %5zu -> %5zu bytes (%.2fx), compress=%7.1f MB/s, decompress=%7.1f MB/s%s\n",
+               argv[2], MAX_ARRAY, buffer_size, packed_size, (double)buffer_size / packed_size, compress_mbs, decompress_mbs,
+               SOCKET_LZ_THRESHOLD == 0 || buffer_size < SOCKET_LZ_THRESHOLD || packed_size >= buffer_size
+                   ? " (frame sent as is)"
+                   : "");
+
+        /* delta is stateful: what it sends on a stream of snapshots */
+        if (strcmp(argv[2], "delta") == 0) {
+            double message_bytes = 0.0, keyframe_bytes = 0.0;
+            if (do_delta_stream_benchmark(test_number, &message_bytes, &keyframe_bytes, &encode_ns, &decode_ns) != 0) {
+                fprintf(stderr, "delta stream benchmark failed\n");
+                goto done;
+            }
+            printf("%s %2d record(s) stream: %7.1f bytes/message (keyframe %.0f), encode=%9.2f ns, decode=%9.2f ns\n",
+                   argv[2], MAX_ARRAY, message_bytes, keyframe_bytes, encode_ns, decode_ns);
+        }
+
+        /* column is meant for scans far above MAX_ARRAY */
+        if (strcmp(argv[2], "column") == 0) {
+            size_t batch_size = 0;
+            double records_ns = 0.0, batch_ns = 0.0;
+            if (do_column_batch_benchmark(test_number / 1000 + 1, &batch_size, &encode_ns, &records_ns, &batch_ns) != 0) {
+                fprintf(stderr, "column batch benchmark failed\n");
+                goto done;
+            }
+            printf("%s %d record(s) batch: %.1f bytes/record, encode=%6.2f ns/record, decode_records=%6.2f ns/record, "
+                   "decode_batch=%6.2f ns/record\n",
+                   argv[2], COLUMN_BATCH_RECORDS, (double)batch_size / COLUMN_BATCH_RECORDS, encode_ns, records_ns,
+                   batch_ns);
+        }
+
+        /* the frame checksum on one record and on the largest array */
+        int crc_sizes[] = {MAX_ARRAY, 1};
+        for (size_t i = 0; i < sizeof(crc_sizes) / sizeof(crc_sizes[0]); i++) {
+            double hw_ns = 0.0, sw_ns = 0.0;
+            if ((crc_sizes[i] == 1 && do_codec_benchmark(argv[2], infos, 1, 1, &encode_ns, &decode_ns) != 0) ||
+                do_crc_benchmark(bytes_buffer, buffer_size, test_number, &hw_ns, &sw_ns) != 0) {
+                fprintf(stderr, "crc benchmark failed\n");
+                goto done;
+            }
+            printf("%s %2d record(s) crc32c: %5zu bytes, %s=%7.2f ns, slicing-by-8=%7.2f ns\n", argv[2], crc_sizes[i],
+                   buffer_size, crc32c_hw_available() ? "sse4.2" : "no sse4.2, sw", hw_ns, sw_ns);
+        }
+
+        ret = 0;
+
+    } else if (strcmp(argv[3], "conformance_test") == 0) {
+        int test_number = 1000;
+        if (argc >= 5) test_number = atoi(argv[4]);
+        char* reference = reference_library(argv[2]);
+        if (test_number <= 0) {
+            print_usage(argc, argv);
+            goto done;
+        }
+
+        if (do_conformance_test(argv[2], reference, test_number) != 0) {
+            fprintf(stderr, "conformance test failed\n");
+            goto done;
+        }
+        if (reference) {
+            printf("%s matches %s in %d tests\n", argv[2], reference, test_number);
+        } else {
+            printf("%s round-trips %d tests\n", argv[2], test_number);
+        }
+        if (strcmp(argv[2], "delta") == 0) {
+            int rejected = 0;
+            if (do_delta_stream_test(test_number, &rejected) != 0) {
+                fprintf(stderr, "delta stream test failed\n");
+                goto done;
+            }
+            printf("delta stream: %d snapshots, %d rejected out of sync and resent as keyframes\n", test_number, rejected);
+        }
+        if (strcmp(argv[2], "column") == 0) {
+            int batches = test_number / 100 + 1;
+            if (do_column_batch_test(batches) != 0) {
+                fprintf(stderr, "column batch test failed\n");
+                goto done;
+            }
+            printf("column batch: %d batches of up to %d records, decode_records and decode_batch match\n", batches,
+                   COLUMN_BATCH_RECORDS);
+        }
+        ret = 0;
+
     } else if (strcmp(argv[3], "no_socket") == 0) {
         /* test encode/decode without socket */
         getSingleSampleData(&info, 0);
@@ -435,16 +1089,16 @@ int main(int argc, char** argv) {
             goto done;
         }
 
-        memset(bytes_buffer, 0, MAX_BUFFER);
+        void* payload = NULL;
         buffer_size = 0;
 
         // get data from socket
-        if (do_server(argv[4], bytes_buffer, &buffer_size) != 0) {
+        if (do_server(argv[4], &payload, &buffer_size) != 0) {
             fprintf(stderr, "server failed\n");
             goto done;
         }
 
-        int result = decode(argv[2], bytes_buffer, buffer_size, &info);
+        int result = decode(argv[2], payload, buffer_size, &info);
         if (result != 0) {
             fprintf(stderr, "decode failed\n");
             goto done;
@@ -463,6 +1117,30 @@ int main(int argc, char** argv) {
         buffer_size = 0;
 
         getSingleSampleData(&info, 0);
+        if (strcmp(argv[2], "mpack") == 0) {
+            /* pooled pages, sent as they are and returned to the pool */
+            mpack_page_chain_t chain;
+            if (mpack_encode_paged(&info, &chain) != 0) {
+                fprintf(stderr, "encode failed\n");
+                goto done;
+            }
+            if (SHOW_STRUCTURE) {
+                printf("Serialized struct done\nBuffer size: %zu\n", chain.total);
+                for (mpack_page_t* page = chain.head; page; page = page->next) {
+                    for (size_t i = 0; i < page->used; i++) {
+                        printf("%02X ", (unsigned char)page->data[i]);
+                    }
+                }
+                printf("\n");
+            }
+            if (mpack_send_pages(argv[4], argv[5], &chain) != 0) {
+                fprintf(stderr, "do_client failed\n");
+                goto done;
+            }
+            ret = 0;
+            goto done;
+        }
+
         if (encode(argv[2], &info, bytes_buffer, &buffer_size) != 0) {
             perror("encode failed\n");
             goto done;
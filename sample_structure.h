@@ -9,8 +9,12 @@
 #include <string.h>
 #include <sys/socket.h>
 #include <sys/types.h>
+#include <sys/uio.h>
 #include <unistd.h>
 
+#include "CRC/crc_usage.h"
+#include "LZ/lz_usage.h"
+
 #define MAX_ARRAY 20
 #define MAX_BUFFER 4096
 
@@ -132,20 +136,108 @@ static int recv_all(int fd, void* buf, size_t len) {
 }
 
 /* ---------- socket helpers (modular) ---------- */
+/*
+ * Frame: an 8-byte length word in network order, then the payload. The top
+ * byte of the word holds FRAME_FLAG_* bits, the low 56 bits the size of the
+ * payload as sent.
+ * FRAME_FLAG_LZ: the payload is the uncompressed size (4 bytes, network
+ * order) and one lz_compress() block. The sender sets it for payloads of
+ * SOCKET_LZ_THRESHOLD bytes or more (up to LZ_MAX_INPUT) that do get
+ * smaller; the receiver accepts both.
+ * FRAME_FLAG_CRC32C: a 4-byte trailer in network order follows the payload,
+ * the crc32c_hw() of the length word and the payload as sent. The sender sets
+ * it unless SOCKET_CRC32C is 0, the receiver checks it before the payload
+ * is decompressed or decoded. With SOCKET_CRC32C the receiver also refuses
+ * frames without it, unless SOCKET_CRC32C_LENIENT is 1 (peers that send
+ * none); with SOCKET_CRC32C 0 it accepts both.
+ * The receiver sizes its buffers from the frame header and keeps them for
+ * the next frame. A payload, as sent or uncompressed, larger than
+ * SOCKET_MAX_FRAME is refused before anything is allocated.
+ */
+#ifndef SOCKET_LZ_THRESHOLD
+#define SOCKET_LZ_THRESHOLD 1024 /* 0: never compress */
+#endif
+#ifndef SOCKET_CRC32C
+#define SOCKET_CRC32C 1 /* 0: no checksum trailer */
+#endif
+#ifndef SOCKET_CRC32C_LENIENT
+#define SOCKET_CRC32C_LENIENT 0 /* 1: accept frames without the trailer */
+#endif
+#ifndef SOCKET_MAX_FRAME
+#define SOCKET_MAX_FRAME ((size_t)1 << 24) /* 16 MiB */
+#endif
+#define FRAME_FLAGS_SHIFT 56
+#define FRAME_SIZE_MASK ((UINT64_C(1) << FRAME_FLAGS_SHIFT) - 1)
+#define FRAME_FLAG_LZ 0x80
+#define FRAME_FLAG_CRC32C 0x40
+#define FRAME_LZ_HEADER_LEN 4 /* uncompressed size before the block */
 
 /*
- * socket_send
+ * frame_compress
+ *  - iov, iovcnt, size: the payload
+ *  - output: *out, the compressed payload in a static buffer
+ *  - return 1 if the frame goes out compressed, 0 if as it is
+ * Not reentrant: the gather and output buffers are static, as is the hash
+ * table of lz_compress(), so one thread sends at a time.
+ */
+static int frame_compress(const struct iovec* iov, int iovcnt, size_t size, struct iovec* out) {
+    static uint8_t plain[LZ_MAX_INPUT];
+    static uint8_t packed[FRAME_LZ_HEADER_LEN + LZ_COMPRESS_BOUND(LZ_MAX_INPUT)];
+    size_t packed_size;
+
+    if (SOCKET_LZ_THRESHOLD == 0 || size < SOCKET_LZ_THRESHOLD || size > LZ_MAX_INPUT) return 0;
+
+    /* the compressor needs the payload in one piece */
+    const void* src = iov[0].iov_base;
+    if (iovcnt > 1) {
+        size_t at = 0;
+        for (int i = 0; i < iovcnt; i++) {
+            memcpy(plain + at, iov[i].iov_base, iov[i].iov_len);
+            at += iov[i].iov_len;
+        }
+        src = plain;
+    }
+
+    if (lz_compress(src, size, packed + FRAME_LZ_HEADER_LEN, sizeof(packed) - FRAME_LZ_HEADER_LEN, &packed_size) != 0 ||
+        FRAME_LZ_HEADER_LEN + packed_size >= size) {
+        return 0;
+    }
+    uint32_t netsize = htonl((uint32_t)size);
+    memcpy(packed, &netsize, sizeof(netsize));
+    out->iov_base = packed;
+    out->iov_len = FRAME_LZ_HEADER_LEN + packed_size;
+    return 1;
+}
+
+/*
+ * frame_reserve
+ *  - grows *buf (capacity *cap) to at least size bytes, keeps it otherwise
+ *  - return the buffer, NULL if it can not grow
+ */
+static void* frame_reserve(void** buf, size_t* cap, size_t size) {
+    if (size > *cap) {
+        void* grown = realloc(*buf, size);
+        if (!grown) return NULL;
+        *buf = grown;
+        *cap = size;
+    }
+    return *buf;
+}
+
+/*
+ * socket_sendv
  *  - host: IP or hostname (we use inet_pton for simplicity; pass IP string)
  *  - portstr: decimal port string
- *  - buffer, size: payload to send
+ *  - iov, iovcnt: payload to send, as pieces sent back to back in one frame
  *  - return 0 on success, -1 on failure
  */
-static int socket_send(const char* host, const char* portstr, void* buffer, size_t size) {
+static int socket_sendv(const char* host, const char* portstr, const struct iovec* iov, int iovcnt) {
     int ret = -1;
     /* Create socket */
     int port = atoi(portstr);
     struct sockaddr_in addr;
     int sock = socket(AF_INET, SOCK_STREAM, 0);
+    size_t size = 0;
 
     if (sock < 0) {
         perror("socket");
@@ -167,15 +259,39 @@ static int socket_send(const char* host, const char* portstr, void* buffer, size
     }
 
     /* send 8-byte length in network order, then payload */
-    uint64_t netlen = htobe64((uint64_t)size);
+    for (int i = 0; i < iovcnt; i++) size += iov[i].iov_len;
+    uint64_t flags = 0;
+    struct iovec packed;
+    if (frame_compress(iov, iovcnt, size, &packed)) {
+        printf("Client: %zu bytes compressed to %zu\n", size, packed.iov_len);
+        iov = &packed;
+        iovcnt = 1;
+        size = packed.iov_len;
+        flags |= FRAME_FLAG_LZ;
+    }
+    if (SOCKET_CRC32C) flags |= FRAME_FLAG_CRC32C;
+    uint64_t netlen = htobe64(flags << FRAME_FLAGS_SHIFT | (uint64_t)size);
     if (send_all(sock, &netlen, sizeof(netlen)) != 0) {
         perror("send len");
         goto cleanup;
     }
 
-    if (send_all(sock, buffer, size) != 0) {
-        perror("send payload");
-        goto cleanup;
+    uint32_t crc = 0;
+    if (flags & FRAME_FLAG_CRC32C) crc = crc32c_hw(0, &netlen, sizeof(netlen));
+    for (int i = 0; i < iovcnt; i++) {
+        if (send_all(sock, iov[i].iov_base, iov[i].iov_len) != 0) {
+            perror("send payload");
+            goto cleanup;
+        }
+        if (flags & FRAME_FLAG_CRC32C) crc = crc32c_hw(crc, iov[i].iov_base, iov[i].iov_len);
+    }
+
+    if (flags & FRAME_FLAG_CRC32C) {
+        uint32_t netcrc = htonl(crc);
+        if (send_all(sock, &netcrc, sizeof(netcrc)) != 0) {
+            perror("send checksum");
+            goto cleanup;
+        }
     }
 
     printf("Client: sent %zu bytes\n", size);
@@ -186,16 +302,38 @@ cleanup:
     return ret;
 }
 
+/*
+ * socket_send
+ *  - host: IP or hostname (we use inet_pton for simplicity; pass IP string)
+ *  - portstr: decimal port string
+ *  - buffer, size: payload to send
+ *  - return 0 on success, -1 on failure
+ */
+static int socket_send(const char* host, const char* portstr, void* buffer, size_t size) {
+    struct iovec iov = {.iov_base = buffer, .iov_len = size};
+    return socket_sendv(host, portstr, &iov, 1);
+}
+
 /*
  * socket_receive
  *  - portstr: port to listen
- *  - buffer: pointer to buffer containing payload (returned)
+ *  - buffer: set to the payload, in a buffer owned by socket_receive that
+ *    stays valid until the next call
  *  - size: payload size returned
  *  - returns 0 on success, -1 on failure
  *
- * Note: this function accepts one client connection and returns its payload.
+ * Note: this function accepts one client connection and returns its payload,
+ * checked against its FRAME_FLAG_CRC32C trailer and decompressed if it has
+ * FRAME_FLAG_LZ. Frames without the trailer are refused if SOCKET_CRC32C is
+ * set and SOCKET_CRC32C_LENIENT is not. Payloads up to SOCKET_MAX_FRAME bytes are accepted.
  */
-static int socket_receive(const char* portstr, void* buffer, size_t* size) {
+static int socket_receive(const char* portstr, void** buffer, size_t* size) {
+    /* sized from the frame headers, reused by the next call */
+    static void* payload_buf = NULL;
+    static size_t payload_cap = 0;
+    static void* plain_buf = NULL;
+    static size_t plain_cap = 0;
+
     int ret = -1;
     if (!portstr || !buffer || !size) return ret;
     int port = atoi(portstr);
@@ -238,21 +376,79 @@ static int socket_receive(const char* portstr, void* buffer, size_t* size) {
         goto cleanup_all;
     }
 
-    *size = (size_t)be64toh(netlen);
-    if (*size == 0) {
+    uint64_t length = be64toh(netlen);
+    int flags = (int)(length >> FRAME_FLAGS_SHIFT);
+    *size = (size_t)(length & FRAME_SIZE_MASK);
+    if (flags & ~(FRAME_FLAG_LZ | FRAME_FLAG_CRC32C)) {
+        fprintf(stderr, "unknown frame flags 0x%02x\n", flags);
+        goto cleanup_all;
+    } else if (SOCKET_CRC32C && !SOCKET_CRC32C_LENIENT && !(flags & FRAME_FLAG_CRC32C)) {
+        fprintf(stderr, "frame without crc32c trailer\n");
+        goto cleanup_all;
+    } else if (*size == 0) {
         perror("invalid size 0");
         goto cleanup_all;
-    } else if (*size > MAX_BUFFER) {
-        perror("size too large");
+    } else if (*size > SOCKET_MAX_FRAME) {
+        fprintf(stderr, "frame of %zu bytes, at most %zu\n", *size, (size_t)SOCKET_MAX_FRAME);
         goto cleanup_all;
     }
 
-    if (recv_all(csock, buffer, *size) != 0) {
+    void* payload = frame_reserve(&payload_buf, &payload_cap, *size);
+    if (!payload) {
+        perror("payload buffer");
+        goto cleanup_all;
+    }
+    if (recv_all(csock, payload, *size) != 0) {
         perror("recv payload");
         goto cleanup_all;
     }
 
+    if (flags & FRAME_FLAG_CRC32C) {
+        uint32_t netcrc;
+        if (recv_all(csock, &netcrc, sizeof(netcrc)) != 0) {
+            perror("recv checksum");
+            goto cleanup_all;
+        }
+        uint32_t crc = crc32c_hw(crc32c_hw(0, &netlen, sizeof(netlen)), payload, *size);
+        if (crc != ntohl(netcrc)) {
+            fprintf(stderr, "frame checksum mismatch: 0x%08x, sent 0x%08x\n", crc, ntohl(netcrc));
+            goto cleanup_all;
+        }
+    }
+
+    if (flags & FRAME_FLAG_LZ) {
+        uint32_t netsize;
+        size_t plain_size;
+        if (*size < FRAME_LZ_HEADER_LEN) {
+            fprintf(stderr, "compressed frame of %zu bytes\n", *size);
+            goto cleanup_all;
+        }
+        memcpy(&netsize, payload, sizeof(netsize));
+        size_t expected = ntohl(netsize);
+        if (expected == 0 || expected > SOCKET_MAX_FRAME) {
+            fprintf(stderr, "compressed frame of %zu bytes uncompressed, at most %zu\n", expected, (size_t)SOCKET_MAX_FRAME);
+            goto cleanup_all;
+        }
+        void* plain = frame_reserve(&plain_buf, &plain_cap, expected);
+        if (!plain) {
+            perror("decompress buffer");
+            goto cleanup_all;
+        }
+        if (lz_decompress((uint8_t*)payload + FRAME_LZ_HEADER_LEN, *size - FRAME_LZ_HEADER_LEN, plain, expected,
+                          &plain_size) != 0) {
+            goto cleanup_all;
+        }
+        if (plain_size != expected) {
+            fprintf(stderr, "compressed frame: %zu bytes uncompressed, header says %zu\n", plain_size, expected);
+            goto cleanup_all;
+        }
+        printf("Server: %zu bytes decompressed to %zu\n", *size, plain_size);
+        payload = plain;
+        *size = plain_size;
+    }
+
     printf("Server: expecting %zu bytes\n", *size);
+    *buffer = payload;
     ret = 0;
 
 cleanup_all:
@@ -288,11 +484,11 @@ int do_client(const char* host, const char* portstr, void* buffer, size_t size)
 /*
  * do_server
  *  - portstr to listen
- *  - out_buffer: pointer to buffer containing payload (returned)
+ *  - out_buffer: set to the payload, valid until the next do_server call
  *  - out_size: payload size returned
  *  - returns 0 on success
  */
-int do_server(const char* portstr, void* out_buffer, size_t* out_size) {
+int do_server(const char* portstr, void** out_buffer, size_t* out_size) {
     if (!portstr || !out_buffer || !out_size) return -1;
 
     int result = socket_receive(portstr, out_buffer, out_size);